@@ -0,0 +1,50 @@
+#include "util/AdaptiveIdle.hpp"
+
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+namespace util {
+
+    std::chrono::nanoseconds threadCpuTime() {
+#ifdef _WIN32
+        FILETIME creation, exit, kernel, user;
+        if(!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+            return {};
+        }
+        auto toTicks = [](const FILETIME& time) {
+            return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        };
+        // FILETIME is in 100 nanosecond ticks
+        return std::chrono::nanoseconds{ (toTicks(kernel) + toTicks(user)) * 100 };
+#else
+        timespec time{};
+        clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+        return std::chrono::seconds{time.tv_sec} + std::chrono::nanoseconds{time.tv_nsec};
+#endif
+    }
+
+    void IdleStats::report(std::chrono::seconds interval) {
+        using namespace std::chrono;
+        const auto now = Clock::now();
+        if(now - lastReport < interval) return;
+
+        if(periods > 0) {
+            const auto idleMs = duration<double, std::milli>(idle).count();
+            const auto cpuMs = duration<double, std::milli>(cpu).count();
+            const auto latencyMs = wakes > 0 ? duration<double, std::milli>(wakeLatency).count() / static_cast<double>(wakes) : 0.0;
+            spdlog::debug("idle: {} periods, {} waits, {:.1f} ms idle, cpu {:.2f} ms ({:.2f}%), wake latency avg {:.2f} ms max {:.2f} ms"
+                          , periods, waits, idleMs, cpuMs, idleMs > 0 ? cpuMs / idleMs * 100.0 : 0.0
+                          , latencyMs, duration<double, std::milli>(maxWakeLatency).count());
+        }
+
+        *this = IdleStats{};
+        lastReport = now;
+    }
+}
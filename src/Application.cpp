@@ -1,5 +1,6 @@
 #include "vr/Application.hpp"
 #include "vr/SessionService.hpp"
+#include "vr/EventPump.hpp"
 #include "xr_struct_mapping.hpp"
 #include "vr/ToString.hpp"
 
@@ -49,33 +50,40 @@ namespace vr {
             SessionService session{ *context, m_sessionConfig, graphicsService, m_renderer };
             session.init();
 
-            auto event = makeStruct<XrEventDataBuffer>();
-            while(session.isRunning()) {
+            EventPump eventPump{ context->instance };
+            eventPump
+                .on(XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED, [&](const auto& event){ session.handle(event); })
+                .on(XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING, [&](const auto&){ session.stop(); })
+                .on(XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED, [](const auto&){})
+                .on(XR_TYPE_EVENT_DATA_REFERENCE_SPACE_CHANGE_PENDING, [](const auto&){})
+                .on<XrEventDataEventsLost>(XR_TYPE_EVENT_DATA_EVENTS_LOST, [](const auto& event){
+                    spdlog::warn("runtime dropped {} events", event.lostEventCount);
+                });
 
+            while(session.isRunning()) {
+                const auto frameLoopActive = session.isFrameLoopActive();
 #ifdef USE_MIRROR_WINDOW
-                WindowingSystem::pollEvents();
+                if(frameLoopActive) {
+                    WindowingSystem::pollEvents();
+                }
 #endif
+                const auto eventsHandled = eventPump.pump();
+                session.processFrame();
 
-                if(pollEvents(*context, event)) {
-                    switch (event.type) {
-                        case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED :
-                            session.handle(event);
-                            break;
-                        case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING :
-                            session.stop();
-                            break;
-                        case XR_TYPE_EVENT_DATA_INTERACTION_PROFILE_CHANGED:
-                            break;
-                        default: {
-                            char buffer[XR_MAX_STRUCTURE_NAME_SIZE];
-                            xrStructureTypeToString(context->instance, event.type, buffer);
-                            THROW(std::format("Event[{}] type not yet implemented!", buffer));
-                        }
-                    }
+                if(frameLoopActive) {
+                    m_idle.reset();
+                }else {
+                    // no frame to wait on, so back off until the runtime has something for us
+                    m_idle.idle(eventsHandled > 0, [](auto timeout){
+#ifdef USE_MIRROR_WINDOW
+                        WindowingSystem::waitEvents(timeout);
+#else
+                        std::this_thread::sleep_for(timeout);
+#endif
+                    });
                 }
-
-                session.processFrame();
             }
+            session.dumpProfile();
 
 #ifdef USE_MIRROR_WINDOW
             graphicsService->shutdownMirrorWindow();
@@ -96,12 +104,6 @@ namespace vr {
         spdlog::info("XR instance terminated, exiting application");
     }
 
-    bool Application::pollEvents(const Context& context, XrEventDataBuffer& event) {
-        event.type = XR_TYPE_EVENT_DATA_BUFFER;
-        auto result = xrPollEvent(context.instance, &event);
-        return result != XR_EVENT_UNAVAILABLE;
-    }
-
     void Application::shutdown() {
     }
 
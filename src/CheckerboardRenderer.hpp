@@ -41,14 +41,14 @@ struct CheckerboardRenderer : public vr::VulkanRenderer {
         const auto& swapChain = graphicsService().getSwapChain("Checkerboard");
 
         VkDeviceSize size = swapChain.width * swapChain.height * 4;
-        auto buffer = graphicsService().createStagingBuffer(size);
-        auto mapping = graphicsService().map(buffer);
-        auto colors = mapping.as<Color>();
+        auto& uploads = graphicsService().uploads();
         const auto w = int(swapChain.width);
         const auto h = int(swapChain.height);
 
         for (auto layerId = 0u; layerId < m_layers.size(); layerId++) {
             auto& layer = m_layers[layerId];
+            auto staging = uploads.stage(size);
+            auto colors = staging.as<Color>();
             for (auto i = 0; i < h; i++) {
                 for (auto j = 0; j < w; j++) {
                     vec2 uv{
@@ -66,8 +66,19 @@ struct CheckerboardRenderer : public vr::VulkanRenderer {
                     colors[id].a = static_cast<char>(col.a * 255);
                 }
             }
-            for(auto imageIndex = 0u; imageIndex < swapChain.images.size(); imageIndex++) {
-                graphicsService().copyToImage({ buffer, {swapChain._, imageIndex}, 0, layerId });
+
+            VkBufferImageCopy region{0, 0, 0};
+            region.imageOffset = {0, 0, 0};
+            region.imageExtent = {swapChain.width, swapChain.height, 1};
+            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+            region.imageSubresource.mipLevel = 0;
+            region.imageSubresource.baseArrayLayer = layerId;
+            region.imageSubresource.layerCount = 1;
+
+            VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, layerId, 1};
+            for(const auto& image : swapChain.images) {
+                uploads.copyToImage(staging, image.image, { &region, 1 }, range
+                                    , VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
             }
 
             layer.eyeVisibility = static_cast<XrEyeVisibility>(layerId);
@@ -80,7 +91,7 @@ struct CheckerboardRenderer : public vr::VulkanRenderer {
             layer.size = {1, 1};
         }
 
-        graphicsService().release(buffer);
+        uploads.submit();
     }
 
 
@@ -51,7 +51,11 @@ struct ClearScreen : public vr::VulkanRenderer {
         elapsedTimeSeconds += static_cast<float>(frameInfo.predictedDuration) * 1E-9f;
         const auto swapChain = graphicsService().getSwapChain("main");
         int colorIndex = static_cast<int>(elapsedTimeSeconds/5)%3;
-        graphicsService().scoped([&](auto cmdBuffer){
+        auto cmdBuffer = graphicsService().frameCommandBuffers(1).front();
+        auto beginInfo = makeStruct<VkCommandBufferBeginInfo>();
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(cmdBuffer, &beginInfo);
+        {
             auto info = makeStruct<VkRenderingInfo>();
             info.flags = 0;
             info.renderArea = {{0, 0}, {swapChain.width, swapChain.height}};
@@ -70,7 +74,13 @@ struct ClearScreen : public vr::VulkanRenderer {
             vkCmdBeginRendering(cmdBuffer, &info);
 
             vkCmdEndRendering(cmdBuffer);
-        });
+        }
+        vkEndCommandBuffer(cmdBuffer);
+
+        auto submitInfo = makeStruct<VkSubmitInfo>();
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &cmdBuffer;
+        graphicsService().submitToGraphicsQueue(submitInfo);
         for(int i = 0; i < 2; i++){
             auto& view = layerViews[i];
             view.pose = frameInfo.viewInfo.views[i].pose;
@@ -61,6 +61,23 @@ namespace vr {
         std::vector<const char*> extensions = creation.extensions;
         extensions.push_back(creation.graphicsExtension());
 
+        if(!creation.optionalExtensions.empty()) {
+            auto [result, available] = enumerate<XrExtensionProperties>([](auto size, auto ptr) {
+                return xrEnumerateInstanceExtensionProperties(nullptr, *size, size, ptr);
+            });
+            CHECK_XR(result);
+            for(auto extension : creation.optionalExtensions) {
+                auto supported = std::any_of(available.begin(), available.end(), [extension](const auto& props){
+                    return std::string_view{props.extensionName} == extension;
+                });
+                if(supported) {
+                    extensions.push_back(extension);
+                }else {
+                    spdlog::info("optional extension {} not supported by runtime", extension);
+                }
+            }
+        }
+
         strcpy_s(createInfo.applicationInfo.applicationName, creation._appName.c_str());
         createInfo.applicationInfo.applicationVersion = creation._appVersion;
 
@@ -71,7 +88,7 @@ namespace vr {
         createInfo.enabledExtensionCount = extensions.size();
         createInfo.enabledExtensionNames = extensions.data();
 
-        Context ctx{ .info = createInfo };
+        Context ctx{ .info = createInfo, .extensions = { extensions.begin(), extensions.end() } };
 
         auto result = xrCreateInstance(&createInfo, &ctx.instance);
         if(XR_FAILED(result)) {
@@ -112,6 +129,10 @@ namespace vr {
                 std::any_of(viewTypes.begin(), viewTypes.end(), [type](const auto viewType){ return viewType == type; });
     }
 
+    bool Context::isEnabled(std::string_view extension) const {
+        return std::any_of(extensions.begin(), extensions.end(), [extension](const auto& enabled){ return enabled == extension; });
+    }
+
     std::vector<XrViewConfigurationView> Context::views(XrViewConfigurationType viewType) const {
         auto [result, views] = enumerate<XrViewConfigurationView>([&](auto size, auto ptr) {
             return xrEnumerateViewConfigurationViews(instance, systemId, viewType, *size, size, ptr);
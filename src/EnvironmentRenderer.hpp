@@ -5,6 +5,7 @@
 #include "vr/SessionConfig.hpp"
 #include "util/collections.hpp"
 #include "util/types.hpp"
+#include "vr/ActionTable.hpp"
 
 #include <stb_image.h>
 
@@ -12,6 +13,10 @@ enum class EnvType {
     CUBE_MAP, EQUI_RECTANGULAR
 };
 
+inline constexpr vr::ActionTable EnvironmentActions{ "main", "", {
+    {"a", vr::Source::RIGHT_HAND, vr::Identifier::A, vr::Component::CLICK}
+}};
+
 class EnvironmentRenderer : public vr::VulkanRenderer {
 public:
     ~EnvironmentRenderer() override = default;
@@ -19,6 +24,7 @@ public:
     void init() override {
         loadCubeMap();
         loadEquirectMap();
+        graphicsService().uploads().submit();
     }
 
     void loadCubeMap() {
@@ -31,8 +37,8 @@ public:
 
         VkDeviceSize size = swapChain.width * swapChain.height * 4;
         VkDeviceSize offset = 0;
-        auto staging = graphicsService().createStagingBuffer(size * faces.size());
-        auto mapping = graphicsService().map(staging);
+        auto& uploads = graphicsService().uploads();
+        auto staging = uploads.stage(size * faces.size());
 
         std::array<VkBufferImageCopy, 6> regions{};
 
@@ -40,8 +46,7 @@ public:
             auto path = std::format("{}\\{}.jpg", rootPath, faces[face]);
             int w, h, c;
             auto image = stbi_load(path.c_str(), &w, &h, &c, STBI_rgb_alpha);
-            auto dst = reinterpret_cast<stbi_uc*>(mapping._) + offset;
-            std::memcpy(dst, image, size);
+            std::memcpy(staging.data + offset, image, size);
             stbi_image_free(image);
             regions[face].bufferOffset = offset;
             regions[face].imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
@@ -52,35 +57,12 @@ public:
             regions[face].imageExtent = {static_cast<uint32_t>(w), static_cast<uint32_t>(h), 1u};
             offset += size;
         }
-//        mapping.unmap();
-
-        graphicsService().scoped([&](auto commandBuffer) {
-
-            for(auto image : swapChain.images) {
-                auto barrier = makeStruct<VkImageMemoryBarrier>();
-                barrier.srcAccessMask = VK_ACCESS_NONE;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barrier.image = image.image;
-                barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                barrier.subresourceRange.baseMipLevel = 0;
-                barrier.subresourceRange.levelCount = 1;
-                barrier.subresourceRange.baseArrayLayer = 0;
-                barrier.subresourceRange.layerCount = 6;
-
-                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,nullptr, 0, nullptr, 1, &barrier);
 
-                vkCmdCopyBufferToImage(commandBuffer, staging._, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), regions.data());
-
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.dstAccessMask = VK_ACCESS_NONE;
-                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, 0,nullptr, 0, nullptr, 1, &barrier);
-            }
-        });
+        VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 6};
+        for(auto image : swapChain.images) {
+            uploads.copyToImage(staging, image.image, regions, range
+                                , VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        }
     }
 
     void loadEquirectMap() {
@@ -99,9 +81,9 @@ public:
 
         uint32_t numPixels = swapChain.width * swapChain.height * STBI_rgb_alpha;
         VkDeviceSize size = numPixels * sizeof(uint16_t);
-        auto staging = graphicsService().createStagingBuffer(size);
-        auto mapping = graphicsService().map(staging);
-        auto dst = mapping.as<uint16_t>();
+        auto& uploads = graphicsService().uploads();
+        auto staging = uploads.stage(size);
+        auto dst = staging.as<uint16_t>();
 
         auto hdr_image = stbi_loadf(equirectPath2, &width, &height, &comps, STBI_rgb_alpha);
         auto hdr_uint32 = reinterpret_cast<uint32_t*>(hdr_image);
@@ -110,53 +92,41 @@ public:
             dst[i] = float_to_half_branch(hdr_uint32[i]);
         }
         stbi_image_free(hdr_image);
-        
-        graphicsService().scoped([&](auto commandBuffer){
-
-            VkBufferImageCopy region{0, 0, 0};
-            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            region.imageSubresource.mipLevel = 0;
-            region.imageSubresource.baseArrayLayer = 0;
-            region.imageSubresource.layerCount = 1;
-            region.imageOffset = {0, 0, 0};
-            region.imageExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1u};
-
-            for(auto image : swapChain.images) {
-                auto barrier = makeStruct<VkImageMemoryBarrier>();
-                barrier.srcAccessMask = VK_ACCESS_NONE;
-                barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barrier.image = image.image;
-                barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-                barrier.subresourceRange.baseMipLevel = 0;
-                barrier.subresourceRange.levelCount = 1;
-                barrier.subresourceRange.baseArrayLayer = 0;
-                barrier.subresourceRange.layerCount = 1;
-
-                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,nullptr, 0, nullptr, 1, &barrier);
-
-                vkCmdCopyBufferToImage(commandBuffer, staging._, image.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-                barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-                barrier.dstAccessMask = VK_ACCESS_NONE;
-                barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-                barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-
-                vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, 0,nullptr, 0, nullptr, 1, &barrier);
-            }
-        });
+
+        VkBufferImageCopy region{0, 0, 0};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = 0;
+        region.imageSubresource.baseArrayLayer = 0;
+        region.imageSubresource.layerCount = 1;
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {static_cast<uint32_t>(width), static_cast<uint32_t>(height), 1u};
+
+        VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        for(auto image : swapChain.images) {
+            uploads.copyToImage(staging, image.image, { &region, 1 }, range
+                                , VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        }
+    }
+
+    void bind(const vr::ActionSet &actionSet) override {
+        if(actionSet.name == EnvironmentActions.name) {
+            EnvironmentActions.verify(actionSet);
+            m_actionSet = actionSet.id;
+        }
     }
 
-    std::vector<vr::Vibrate> set(const vr::ActionSet &actionSet) override {
-        if(actionSet.get("a").changed && actionSet.get("a").value<bool>()){
+    void changed(const vr::ActionSet &actionSet, std::span<const vr::ActionId> actions) override {
+        // ids are only unique within a set
+        if(actionSet.id != m_actionSet) return;
+
+        const auto toggled = std::find(actions.begin(), actions.end(), ToggleEnvironment.id) != actions.end();
+        if(toggled && actionSet.value(ToggleEnvironment)){
             if(m_currentLayer->type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR) {
                 m_currentLayer = reinterpret_cast<XrCompositionLayerBaseHeader *>(&m_equiRectLayer);
             }else {
                 m_currentLayer = reinterpret_cast<XrCompositionLayerBaseHeader *>(&m_cubemapLayer);
             }
         }
-        return {};
     }
 
     vr::cstring name() override {
@@ -168,9 +138,9 @@ public:
     }
 
     void render(const vr::FrameInfo &frameInfo, vr::Layers& layers) override {
-        if(m_currentLayer->type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR && frameInfo.imageId.swapChain == m_cubemapLayer.swapchain) {
+        if(m_currentLayer->type == XR_TYPE_COMPOSITION_LAYER_CUBE_KHR && frameInfo.image(m_cubemapLayer.swapchain)) {
             layers.push_back( { m_currentLayer });
-        }else if(m_currentLayer->type == XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR && frameInfo.imageId.swapChain == m_equiRectLayer.subImage.swapchain){
+        }else if(m_currentLayer->type == XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR && frameInfo.image(m_equiRectLayer.subImage.swapchain)){
             layers.push_back( { m_currentLayer } );
         }
     }
@@ -191,11 +161,7 @@ public:
         return
             vr::SessionConfig()
                 .baseSpaceType().local()
-                .addActionSet(
-                        vr::ActionSetSpecification()
-                            .name("main")
-                            .addAction("a", vr::Source::RIGHT_HAND, vr::Identifier::A, vr::Component::CLICK)
-                        )
+                .addActionSet(EnvironmentActions.specification())
                 .addSwapChain(
                     vr::SwapchainSpecification()
                         .name("skybox")
@@ -250,4 +216,6 @@ private:
     XrCompositionLayerEquirectKHR m_equiRectLayer{ XR_TYPE_COMPOSITION_LAYER_EQUIRECT_KHR };
     XrCompositionLayerBaseHeader* m_currentLayer;
     EnvType envType{EnvType::CUBE_MAP};
+    vr::ActionSetId m_actionSet{vr::InvalidActionSetId};
+    static constexpr auto ToggleEnvironment = vr::action<EnvironmentActions, "a">;
 };
\ No newline at end of file
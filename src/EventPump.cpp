@@ -0,0 +1,71 @@
+#include "check.hpp"
+#include "vr/EventPump.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace vr {
+
+    void EventStats::report(std::chrono::seconds interval) {
+        using namespace std::chrono;
+        const auto now = Clock::now();
+        if(frames == 0 || now - lastReport < interval) return;
+
+        if(events > 0) {
+            const auto costUs = duration<double, std::micro>(cost).count();
+            spdlog::debug("events: {} over {} frames, max {} per frame, handling {:.1f} us total, {:.1f} us worst frame"
+                          , events, frames, maxEventsPerFrame, costUs, duration<double, std::micro>(maxCost).count());
+        }
+
+        *this = EventStats{};
+        lastReport = now;
+    }
+
+    EventPump::EventPump(XrInstance instance)
+    : m_instance(instance)
+    {}
+
+    EventPump &EventPump::on(XrStructureType type, Handler handler) {
+        m_handlers[type] = std::move(handler);
+        return *this;
+    }
+
+    uint32_t EventPump::pump() {
+        const auto start = EventStats::Clock::now();
+
+        uint32_t count = 0;
+        while(count < MaxEventsPerFrame) {
+            m_event = makeStruct<XrEventDataBuffer>();
+            auto result = xrPollEvent(m_instance, &m_event);
+            if(result == XR_EVENT_UNAVAILABLE) {
+                break;
+            }
+            if(XR_FAILED(result)) {
+                char buffer[XR_MAX_RESULT_STRING_SIZE];
+                xrResultToString(m_instance, result, buffer);
+                spdlog::error("xrPollEvent failed with {}", buffer);
+                break;
+            }
+            ++count;
+
+            if(auto itr = m_handlers.find(m_event.type); itr != m_handlers.end()) {
+                itr->second(m_event);
+            }else {
+                unhandled(m_event);
+            }
+        }
+
+        m_stats.record(count, EventStats::Clock::now() - start);
+        m_stats.report();
+        return count;
+    }
+
+    void EventPump::unhandled(const XrEventDataBuffer &event) {
+        // only the first occurrence of each type is logged so a chatty runtime doesn't flood the log
+        if(m_unhandled[event.type]++ > 0) return;
+
+        char buffer[XR_MAX_STRUCTURE_NAME_SIZE];
+        xrStructureTypeToString(m_instance, event.type, buffer);
+        spdlog::warn("no handler registered for event {}, ignoring", buffer);
+    }
+}
@@ -0,0 +1,81 @@
+#include "check.hpp"
+#include "vr/FramePacer.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace vr {
+
+    void FramePacingStats::report(const char* mode, std::chrono::seconds interval) {
+        using namespace std::chrono;
+        const auto now = Clock::now();
+        if(frames == 0 || now - lastReport < interval) return;
+
+        const auto count = static_cast<double>(frames);
+        const auto waitMs = duration<double, std::milli>(wait).count() / count;
+        const auto workMs = duration<double, std::milli>(work).count() / count;
+        const auto periodMs = static_cast<double>(displayPeriod) * 1E-6 / count;
+        const auto headroom = periodMs > 0 ? (1.0 - workMs / periodMs) * 100.0 : 0.0;
+
+        spdlog::debug("frame pacing[{}]: {} frames, display period {:.2f} ms, cpu work {:.2f} ms, wait {:.2f} ms, headroom {:.1f}%"
+                      , mode, frames, periodMs, workMs, waitMs, headroom);
+
+        *this = FramePacingStats{};
+        lastReport = now;
+    }
+
+    FramePacer::~FramePacer() {
+        if(m_running) {
+            m_thread.request_stop();
+            m_frames.close();
+        }
+    }
+
+    void FramePacer::start(XrSession session) {
+        assert(!m_running);
+        m_session = session;
+        m_frames.reopen();
+        m_running = true;
+        m_thread = std::jthread{ [this](std::stop_token stopToken){ run(stopToken); } };
+        spdlog::info("frame pacing thread started");
+    }
+
+    void FramePacer::stop(const DiscardFrame& discard) {
+        if(!m_running) return;
+
+        m_thread.request_stop();
+        m_frames.close();
+
+        // the pacing thread may be blocked in xrWaitFrame until the frame it queued is begun
+        while(auto frameState = m_frames.tryPop()) {
+            discard(*frameState);
+        }
+        m_thread.join();
+        m_running = false;
+        spdlog::info("frame pacing thread stopped");
+    }
+
+    bool FramePacer::next(XrFrameState& frameState) {
+        auto next = m_frames.pop();
+        if(!next.has_value()) {
+            return false;
+        }
+        frameState = *next;
+        return true;
+    }
+
+    void FramePacer::run(std::stop_token stopToken) {
+        while(!stopToken.stop_requested()) {
+            auto frameState = makeStruct<XrFrameState>();
+            auto result = xrWaitFrame(m_session, XR_NULL_HANDLE, &frameState);
+            if(XR_FAILED(result)) {
+                spdlog::warn("frame pacing thread: xrWaitFrame failed with result {}", static_cast<int>(result));
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+                continue;
+            }
+            if(!m_frames.push(frameState)) {
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include "vr/FrameProfiler.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <numeric>
+#include <fstream>
+#include <cmath>
+#include <array>
+
+namespace vr {
+
+    namespace {
+        constexpr std::array<const char*, FrameProfiler::BuiltInPhases> BuiltInPhaseNames{
+            "wait", "begin", "action_sync", "space_locate", "acquire", "renderer_record", "submit", "release", "end", "frame"
+        };
+
+        double percentile(const std::vector<float>& sorted, double p) {
+            const auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+            return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+        }
+
+        // phase names come from renderers, quotes, backslashes and control characters are escaped
+        void writeJsonString(std::ostream& out, std::string_view value) {
+            out << '"';
+            for(const auto c : value) {
+                switch(c) {
+                    case '"': out << "\\\""; break;
+                    case '\\': out << "\\\\"; break;
+                    case '\n': out << "\\n"; break;
+                    case '\r': out << "\\r"; break;
+                    case '\t': out << "\\t"; break;
+                    default:
+                        if(static_cast<unsigned char>(c) < 0x20) {
+                            constexpr auto hex = "0123456789abcdef";
+                            out << "\\u00" << hex[(c >> 4) & 0xF] << hex[c & 0xF];
+                        } else {
+                            out << c;
+                        }
+                }
+            }
+            out << '"';
+        }
+    }
+
+    FrameProfiler::FrameProfiler() {
+        for(auto name : BuiltInPhaseNames) {
+            addPhase(name);
+        }
+    }
+
+    PhaseId FrameProfiler::addPhase(std::string_view name) {
+        auto itr = std::find_if(m_series.begin(), m_series.end(), [&](const auto& series){ return series.name == name; });
+        if(itr != m_series.end()) {
+            return static_cast<PhaseId>(std::distance(m_series.begin(), itr));
+        }
+
+        auto& series = m_series.emplace_back();
+        series.name = name;
+        series.window.resize(WindowSize);
+        return static_cast<PhaseId>(m_series.size() - 1);
+    }
+
+    void FrameProfiler::nextFrame() {
+        for(auto& series : m_series) {
+            if(!series.touched) continue;
+
+            series.window[series.next] = series.current;
+            series.next = (series.next + 1) % WindowSize;
+            ++series.samples;
+            series.current = 0;
+            series.touched = false;
+        }
+        ++m_frames;
+    }
+
+    std::vector<PhaseSummary> FrameProfiler::summary() const {
+        std::vector<PhaseSummary> result;
+        result.reserve(m_series.size());
+
+        std::vector<float> sorted;
+        for(const auto& series : m_series) {
+            PhaseSummary phase{ series.name, series.samples };
+            const auto count = static_cast<size_t>(std::min<uint64_t>(series.samples, WindowSize));
+            if(count > 0) {
+                sorted.assign(series.window.begin(), series.window.begin() + count);
+                std::sort(sorted.begin(), sorted.end());
+                phase.p50 = percentile(sorted, 0.50);
+                phase.p95 = percentile(sorted, 0.95);
+                phase.p99 = percentile(sorted, 0.99);
+                phase.max = sorted.back();
+                phase.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(count);
+            }
+            result.push_back(std::move(phase));
+        }
+        return result;
+    }
+
+    void FrameProfiler::write(const std::filesystem::path &path) const {
+        std::ofstream out{ path, std::ios::trunc };
+        if(!out) {
+            spdlog::warn("unable to write frame profile to {}", path.string());
+            return;
+        }
+
+        const auto phases = summary();
+        if(path.extension() == ".json") {
+            out << "{\n  \"frames\": " << m_frames << ",\n  \"window\": " << WindowSize << ",\n  \"phases\": [\n";
+            for(auto i = 0u; i < phases.size(); ++i) {
+                const auto& phase = phases[i];
+                out << "    {\"name\": ";
+                writeJsonString(out, phase.name);
+                out << ", \"samples\": " << phase.samples
+                    << ", \"mean\": " << phase.mean << ", \"p50\": " << phase.p50 << ", \"p95\": " << phase.p95
+                    << ", \"p99\": " << phase.p99 << ", \"max\": " << phase.max << "}"
+                    << (i + 1 < phases.size() ? ",\n" : "\n");
+            }
+            out << "  ]\n}\n";
+        }else {
+            out << "phase,samples,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n";
+            for(const auto& phase : phases) {
+                out << phase.name << ',' << phase.samples << ',' << phase.mean << ',' << phase.p50 << ','
+                    << phase.p95 << ',' << phase.p99 << ',' << phase.max << '\n';
+            }
+        }
+        spdlog::info("frame profile of {} frames written to {}", m_frames, path.string());
+    }
+
+    void FrameProfiler::log() const {
+        for(const auto& phase : summary()) {
+            if(phase.samples == 0) continue;
+            spdlog::info("{:>16}: p50 {:.3f} ms, p95 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms"
+                         , phase.name, phase.p50, phase.p95, phase.p99, phase.max);
+        }
+    }
+}
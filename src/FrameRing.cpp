@@ -0,0 +1,49 @@
+#include "check.hpp"
+#include "vr/graphics/vulkan/FrameRing.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <bit>
+
+namespace vr {
+
+    void FrameRing::init(VmaAllocator allocator, const Buffer &buffer, uint32_t frames, VkDeviceSize regionSize, VkDeviceSize alignment) {
+        assert(buffer.mapped && std::has_single_bit(alignment));
+        assert(buffer.info.size >= regionSize * frames);
+        m_allocator = allocator;
+        m_allocation = buffer.allocation;
+        m_buffer = buffer._;
+        m_data = static_cast<std::byte*>(buffer.mapped);
+        m_alignment = alignment;
+
+        // regions start aligned so allocations at their start are too
+        m_regionSize = regionSize & ~(alignment - 1);
+
+        VkMemoryPropertyFlags properties{};
+        vmaGetAllocationMemoryProperties(m_allocator, m_allocation, &properties);
+        m_coherent = (properties & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT) != 0;
+
+        begin(0);
+        spdlog::info("frame ring initialized with {} KB per frame, {} frames, {} byte alignment{}"
+                     , m_regionSize / 1024, frames, m_alignment, m_coherent ? "" : ", flushed before submit");
+    }
+
+    void FrameRing::begin(uint32_t frameIndex) {
+        m_begin = m_regionSize * frameIndex;
+        m_head = m_begin;
+        m_flushed = m_begin;
+        m_end = m_begin + m_regionSize;
+    }
+
+    void FrameRing::flush() {
+        if(m_coherent || m_head == m_flushed) return;
+
+        CHECK_VULKAN(vmaFlushAllocation(m_allocator, m_allocation, m_flushed, m_head - m_flushed));
+        m_flushed = m_head;
+    }
+
+    void FrameRing::overflow(VkDeviceSize size) const {
+        THROW(std::format("frame ring out of memory, {} bytes requested with {} of {} bytes used this frame"
+                          , size, used(), m_regionSize))
+    }
+}
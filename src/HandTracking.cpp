@@ -0,0 +1,163 @@
+#include "check.hpp"
+#include "vr/HandTracking.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+#include <glm/gtc/constants.hpp>
+
+#include <cmath>
+
+namespace vr {
+
+    namespace {
+        constexpr XrSpaceLocationFlags Tracked = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT
+                                                 | XR_SPACE_LOCATION_POSITION_TRACKED_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT;
+
+        // joints of a finger in the right hand's space: x to the thumb's side, fingers along -z, palm facing -y
+        struct SyntheticFinger {
+            uint32_t firstJoint;
+            uint32_t jointCount;
+            glm::vec3 base;                 // position of the metacarpal joint relative to the wrist
+            float spread;                   // rotation around y, radians
+            std::array<float, 4> lengths;   // from each joint to the next
+            float radius;
+        };
+
+        constexpr std::array<SyntheticFinger, 5> SyntheticFingers{{
+            { XR_HAND_JOINT_THUMB_METACARPAL_EXT, 4, { 0.025f, -0.01f, -0.02f }, 0.7f, { 0.04f, 0.035f, 0.025f }, 0.011f },
+            { XR_HAND_JOINT_INDEX_METACARPAL_EXT, 5, { 0.02f, 0.f, -0.01f }, 0.08f, { 0.065f, 0.04f, 0.025f, 0.02f }, 0.009f },
+            { XR_HAND_JOINT_MIDDLE_METACARPAL_EXT, 5, { 0.f, 0.f, -0.01f }, 0.f, { 0.065f, 0.045f, 0.028f, 0.02f }, 0.009f },
+            { XR_HAND_JOINT_RING_METACARPAL_EXT, 5, { -0.02f, 0.f, -0.01f }, -0.08f, { 0.06f, 0.04f, 0.026f, 0.02f }, 0.008f },
+            { XR_HAND_JOINT_LITTLE_METACARPAL_EXT, 5, { -0.038f, 0.f, -0.01f }, -0.18f, { 0.055f, 0.032f, 0.02f, 0.018f }, 0.007f },
+        }};
+
+        constexpr float CurlPeriod{3.f};    // seconds for the hands to close and open again
+        constexpr float MaxCurl{1.2f};      // radians per finger joint
+    }
+
+    HandTracker::~HandTracker() {
+        destroy();
+    }
+
+    void HandTracker::init(const Context &context, XrSession session, HandTrackingMode mode) {
+        m_mode = HandTrackingMode::Off;
+        if(mode == HandTrackingMode::Off) return;
+
+        if(mode == HandTrackingMode::Synthetic) {
+            m_mode = mode;
+            spdlog::info("hand tracking uses synthetic joints");
+            return;
+        }
+
+        if(!context.isEnabled(XR_EXT_HAND_TRACKING_EXTENSION_NAME)) {
+            spdlog::warn("{} not supported by runtime, hand tracking disabled", XR_EXT_HAND_TRACKING_EXTENSION_NAME);
+            return;
+        }
+
+        auto handTracking = makeStruct<XrSystemHandTrackingPropertiesEXT>();
+        auto systemProperties = makeStruct<XrSystemProperties>();
+        systemProperties.next = &handTracking;
+        CHECK_XR(xrGetSystemProperties(context.instance, context.systemId, &systemProperties));
+        if(!handTracking.supportsHandTracking) {
+            spdlog::warn("system does not support hand tracking, hand tracking disabled");
+            return;
+        }
+
+        CHECK_XR(xrGetInstanceProcAddr(context.instance, "xrCreateHandTrackerEXT", reinterpret_cast<PFN_xrVoidFunction*>(&m_createHandTracker)));
+        CHECK_XR(xrGetInstanceProcAddr(context.instance, "xrDestroyHandTrackerEXT", reinterpret_cast<PFN_xrVoidFunction*>(&m_destroyHandTracker)));
+        CHECK_XR(xrGetInstanceProcAddr(context.instance, "xrLocateHandJointsEXT", reinterpret_cast<PFN_xrVoidFunction*>(&m_locateHandJoints)));
+
+        for(auto i = 0u; i < HandCount; ++i) {
+            auto createInfo = makeStruct<XrHandTrackerCreateInfoEXT>();
+            createInfo.hand = static_cast<Handedness>(i) == Handedness::Left ? XR_HAND_LEFT_EXT : XR_HAND_RIGHT_EXT;
+            createInfo.handJointSet = XR_HAND_JOINT_SET_DEFAULT_EXT;
+            CHECK_XR(m_createHandTracker(session, &createInfo, &m_trackers[i]));
+        }
+        m_mode = HandTrackingMode::Runtime;
+        spdlog::info("hand tracking enabled, {} joints per hand", HandJoints::Count);
+    }
+
+    void HandTracker::locate(XrSpace baseSpace, XrTime time) {
+        if(m_mode == HandTrackingMode::Synthetic) {
+            for(auto i = 0u; i < HandCount; ++i) {
+                synthesize(static_cast<Handedness>(i), time, m_hands[i]);
+            }
+            return;
+        }
+        if(m_mode != HandTrackingMode::Runtime) return;
+
+        for(auto i = 0u; i < HandCount; ++i) {
+            auto locateInfo = makeStruct<XrHandJointsLocateInfoEXT>();
+            locateInfo.baseSpace = baseSpace;
+            locateInfo.time = time;
+
+            auto locations = makeStruct<XrHandJointLocationsEXT>();
+            locations.jointCount = static_cast<uint32_t>(m_locations.size());
+            locations.jointLocations = m_locations.data();
+
+            auto& joints = m_hands[i];
+            joints.isActive = XR_SUCCEEDED(m_locateHandJoints(m_trackers[i], &locateInfo, &locations)) && locations.isActive;
+            if(!joints.isActive) {
+                joints.flags.fill(0);
+                continue;
+            }
+
+            for(auto joint = 0u; joint < HandJoints::Count; ++joint) {
+                const auto& location = m_locations[joint];
+                const auto& p = location.pose.position;
+                const auto& o = location.pose.orientation;
+                joints.positions[joint] = { p.x, p.y, p.z, location.radius };
+                joints.orientations[joint] = { o.w, o.x, o.y, o.z };
+                joints.flags[joint] = location.locationFlags;
+            }
+        }
+    }
+
+    void HandTracker::destroy() {
+        for(auto& tracker : m_trackers) {
+            if(tracker != XR_NULL_HANDLE) {
+                m_destroyHandTracker(tracker);
+                tracker = XR_NULL_HANDLE;
+            }
+        }
+        m_mode = HandTrackingMode::Off;
+    }
+
+    void HandTracker::synthesize(Handedness hand, XrTime time, HandJoints &joints) {
+        const auto seconds = static_cast<float>(static_cast<double>(time) * 1E-9);
+        const auto curl = MaxCurl * 0.5f * (1.f - std::cos(seconds * glm::two_pi<float>() / CurlPeriod));
+
+        // the left hand mirrors the right one across x
+        const auto side = hand == Handedness::Left ? -1.f : 1.f;
+        const glm::vec3 mirror{ side, 1.f, 1.f };
+        const auto mirrorRotation = [&](const glm::quat& q) {
+            return hand == Handedness::Left ? glm::quat{ q.w, q.x, -q.y, -q.z } : q;
+        };
+
+        const Pose wrist{
+            glm::angleAxis(0.2f * std::sin(seconds) * side, glm::vec3{0, 1, 0}),
+            glm::vec3{ 0.15f * side, -0.15f, -0.4f }
+        };
+        const auto place = [&](const glm::vec3& position, const glm::quat& orientation, float radius, uint32_t joint) {
+            joints.positions[joint] = glm::vec4(wrist.position + wrist.orientation * (position * mirror), radius);
+            joints.orientations[joint] = glm::normalize(wrist.orientation * mirrorRotation(orientation));
+            joints.flags[joint] = Tracked;
+        };
+
+        place(glm::vec3{0}, glm::quat{1, 0, 0, 0}, 0.02f, XR_HAND_JOINT_WRIST_EXT);
+        place(glm::vec3{ 0.f, 0.f, -0.05f }, glm::quat{1, 0, 0, 0}, 0.02f, XR_HAND_JOINT_PALM_EXT);
+
+        for(const auto& finger : SyntheticFingers) {
+            auto position = finger.base;
+            auto orientation = glm::angleAxis(finger.spread, glm::vec3{0, 1, 0});
+            place(position, orientation, finger.radius, finger.firstJoint);
+
+            for(auto i = 1u; i < finger.jointCount; ++i) {
+                position += orientation * glm::vec3{ 0, 0, -finger.lengths[i - 1] };
+                orientation = orientation * glm::angleAxis(-curl, glm::vec3{1, 0, 0});   // towards the palm
+                place(position, orientation, finger.radius * (1.f - 0.1f * static_cast<float>(i)), finger.firstJoint + i);
+            }
+        }
+        joints.isActive = true;
+    }
+}
@@ -0,0 +1,102 @@
+#include "util/HeapGuard.hpp"
+
+#ifdef VR_HEAP_GUARD
+
+#include <spdlog/spdlog.h>
+#include <cpptrace/cpptrace.hpp>
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+    thread_local bool g_armed{false};
+
+    void checkAllocation(std::size_t size) {
+        if(!g_armed) return;
+
+        g_armed = false;
+        spdlog::critical("heap guard: {} bytes allocated from the global heap on an armed thread", size);
+        cpptrace::generate_trace(1).print();
+        std::abort();
+    }
+
+    void* allocate(std::size_t size) {
+        checkAllocation(size);
+        if(auto ptr = std::malloc(size == 0 ? 1 : size)) {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void* allocate(std::size_t size, std::align_val_t alignment) {
+        checkAllocation(size);
+        const auto align = static_cast<std::size_t>(alignment);
+#ifdef _WIN32
+        auto ptr = _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+        auto ptr = std::aligned_alloc(align, (size + align - 1) / align * align);
+#endif
+        if(ptr) {
+            return ptr;
+        }
+        throw std::bad_alloc{};
+    }
+
+    void deallocate(void* ptr, std::align_val_t) noexcept {
+#ifdef _WIN32
+        _aligned_free(ptr);
+#else
+        std::free(ptr);
+#endif
+    }
+}
+
+namespace util {
+
+    void HeapGuard::arm() {
+        g_armed = true;
+    }
+
+    void HeapGuard::disarm() {
+        g_armed = false;
+    }
+
+    bool HeapGuard::armed() {
+        return g_armed;
+    }
+}
+
+void* operator new(std::size_t size) { return allocate(size); }
+
+void* operator new[](std::size_t size) { return allocate(size); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, alignment); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    try { return allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept { deallocate(ptr, alignment); }
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { deallocate(ptr, alignment); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept { deallocate(ptr, alignment); }
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { deallocate(ptr, alignment); }
+
+#endif
@@ -0,0 +1,291 @@
+#include "vr/InputRecording.hpp"
+#include "check.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <fstream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace vr {
+
+    namespace {
+
+        template<typename T>
+        void append(std::vector<std::byte>& buffer, const T& value) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto offset = buffer.size();
+            buffer.resize(offset + sizeof(T));
+            std::memcpy(buffer.data() + offset, &value, sizeof(T));
+        }
+
+        template<typename T>
+        void append(std::vector<std::byte>& buffer, std::span<const T> values) {
+            static_assert(std::is_trivially_copyable_v<T>);
+            const auto offset = buffer.size();
+            buffer.resize(offset + values.size_bytes());
+            std::memcpy(buffer.data() + offset, values.data(), values.size_bytes());
+        }
+
+        class Reader {
+        public:
+            explicit Reader(std::span<const std::byte> data)
+            : m_data{data}
+            {}
+
+            template<typename T>
+            bool read(T& value) {
+                return read(std::span<T>{ &value, 1 });
+            }
+
+            template<typename T>
+            bool read(std::span<T> values) {
+                static_assert(std::is_trivially_copyable_v<T>);
+                if(m_offset + values.size_bytes() > m_data.size()) {
+                    return false;
+                }
+                std::memcpy(values.data(), m_data.data() + m_offset, values.size_bytes());
+                m_offset += values.size_bytes();
+                return true;
+            }
+
+        private:
+            std::span<const std::byte> m_data;
+            size_t m_offset{};
+        };
+
+        void write(const ActionState& state, RecordedAction& action) {
+            action.type = static_cast<uint32_t>(state.index());
+            std::visit([&](const auto& value){
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, bool>) {
+                    action.value[0] = value ? 1.f : 0.f;
+                }else if constexpr (std::is_same_v<T, float>) {
+                    action.value[0] = value;
+                }else if constexpr (std::is_same_v<T, glm::vec2>) {
+                    action.value[0] = value.x;
+                    action.value[1] = value.y;
+                }else if constexpr (std::is_same_v<T, Pose>) {
+                    action.value = { value.orientation.w, value.orientation.x, value.orientation.y, value.orientation.z
+                                     , value.position.x, value.position.y, value.position.z };
+                }
+            }, state);
+        }
+
+        ActionState read(const RecordedAction& action) {
+            const auto& v = action.value;
+            switch(action.type) {
+                case 1: return v[0];
+                case 2: return glm::vec2{ v[0], v[1] };
+                case 3: return Pose{ glm::quat{ v[0], v[1], v[2], v[3] }, glm::vec3{ v[4], v[5], v[6] } };
+                default: return v[0] != 0.f;
+            }
+        }
+    }
+
+    void FrameSnapshot::capture(const XrFrameState &frameState) {
+        predictedDisplayTime = frameState.predictedDisplayTime;
+        predictedDisplayPeriod = frameState.predictedDisplayPeriod;
+        shouldRender = frameState.shouldRender;
+    }
+
+    void FrameSnapshot::capture(const XrViewState &viewState, std::span<const XrView> located) {
+        viewStateFlags = viewState.viewStateFlags;
+        viewCount = std::min<uint32_t>(static_cast<uint32_t>(located.size()), MaxViews);
+        for(auto i = 0u; i < viewCount; ++i) {
+            views[i] = { located[i].pose, located[i].fov };
+        }
+    }
+
+    void FrameSnapshot::capture(const SpaceLocator& locator) {
+        spaceCount = std::min<uint32_t>(static_cast<uint32_t>(locator.size()), MaxSpaces);
+        spacesLocated = 0;
+        for(SpaceId id = 0; id < spaceCount; ++id) {
+            spaces[id] = locator.pose(id);
+            if(locator.isLocated(id)) {
+                spacesLocated |= 1u << id;
+            }
+        }
+    }
+
+    void FrameSnapshot::capture(std::span<const ActionSet> actionSets) {
+        actionCount = 0;
+        for(const auto& actionSet : actionSets) {
+            for(ActionId id = 0; id < actionSet.size() && actionCount < MaxActions; ++id) {
+                const auto& state = actionSet[id];
+                auto& action = actions[actionCount++];
+                action = { actionSet.id, id, state.isActive, state.changed };
+                write(state._value, action);
+            }
+        }
+    }
+
+    void FrameSnapshot::apply(XrViewState &viewState, std::span<XrView> located, uint32_t& count) const {
+        viewState.viewStateFlags = viewStateFlags;
+        count = std::min<uint32_t>(viewCount, static_cast<uint32_t>(located.size()));
+        for(auto i = 0u; i < count; ++i) {
+            located[i].pose = views[i].pose;
+            located[i].fov = views[i].fov;
+        }
+    }
+
+    void FrameSnapshot::apply(SpaceLocator& locator) const {
+        const auto count = std::min<uint32_t>(spaceCount, static_cast<uint32_t>(locator.size()));
+        for(SpaceId id = 0; id < count; ++id) {
+            locator.set(id, spaces[id], (spacesLocated & (1u << id)) != 0);
+        }
+    }
+
+    void FrameSnapshot::apply(std::span<ActionSet> actionSets) const {
+        for(auto i = 0u; i < actionCount; ++i) {
+            const auto& action = actions[i];
+            if(action.actionSet >= actionSets.size() || action.action >= actionSets[action.actionSet].size()) {
+                continue;
+            }
+            auto& state = actionSets[action.actionSet][action.action];
+            if(state._value.index() != action.type) continue;   // recorded against a different action layout
+
+            state.isActive = action.isActive;
+            state.changed = action.changed;
+            state._value = read(action);
+        }
+    }
+
+    InputRecorder::InputRecorder(const std::filesystem::path &path)
+    : m_path{path}
+    , m_writer{[this]{ run(); }}
+    {}
+
+    InputRecorder::~InputRecorder() {
+        m_queue.close();
+        if(m_writer.joinable()) {
+            m_writer.join();
+        }
+        spdlog::info("recorded {} frames to {}, {} frames dropped", m_frames, m_path.string(), m_dropped.load());
+    }
+
+    void InputRecorder::submit() {
+        m_frame.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count();
+        if(m_queue.tryPush(m_frame)) {
+            ++m_frames;
+        }else {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_frame.clear();
+    }
+
+    void InputRecorder::run() {
+        std::ofstream out{ m_path, std::ios::binary | std::ios::trunc };
+        if(!out) {
+            spdlog::error("unable to open {} for recording", m_path.string());
+            m_queue.close();
+            return;
+        }
+
+        std::vector<std::byte> buffer;
+        buffer.reserve(sizeof(FrameSnapshot));
+        append(buffer, Magic);
+        append(buffer, Version);
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+
+        while(auto frame = m_queue.pop()) {
+            buffer.clear();
+            append(buffer, uint32_t{});     // size, patched once the frame is encoded
+            append(buffer, frame->timestamp);
+            append(buffer, frame->predictedDisplayTime);
+            append(buffer, frame->predictedDisplayPeriod);
+            append(buffer, static_cast<uint8_t>(frame->shouldRender));
+            append(buffer, frame->viewStateFlags);
+            append(buffer, frame->viewCount);
+            append(buffer, std::span<const RecordedView>{ frame->views.data(), frame->viewCount });
+            append(buffer, frame->spaceCount);
+            append(buffer, frame->spacesLocated);
+            append(buffer, std::span<const Pose>{ frame->spaces.data(), frame->spaceCount });
+            append(buffer, frame->actionCount);
+            append(buffer, std::span<const RecordedAction>{ frame->actions.data(), frame->actionCount });
+
+            const auto size = static_cast<uint32_t>(buffer.size() - sizeof(uint32_t));
+            std::memcpy(buffer.data(), &size, sizeof(size));
+            out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        }
+    }
+
+    InputReplay::InputReplay(const std::filesystem::path &path, ReplayPacing pacing)
+    : m_file{path}
+    , m_pacing{pacing}
+    {
+        if(!m_file.isOpen()) {
+            THROW(std::format("unable to open input recording {}", path.string()));
+        }
+
+        Reader reader{ m_file.data() };
+        uint32_t magic{};
+        uint32_t version{};
+        if(!reader.read(magic) || !reader.read(version) || magic != InputRecorder::Magic) {
+            THROW(std::format("{} is not an input recording", path.string()));
+        }
+        if(version != InputRecorder::Version) {
+            THROW(std::format("input recording {} has version {}, expected {}", path.string(), version, InputRecorder::Version));
+        }
+        m_firstFrame = m_offset = sizeof(magic) + sizeof(version);
+        m_valid = true;
+        spdlog::info("replaying input from {}", path.string());
+    }
+
+    bool InputReplay::next() {
+        if(!isOpen()) return false;
+
+        if(!decode()) {
+            // end of the log, or a frame truncated by a recording that did not shut down
+            m_offset = m_firstFrame;
+            if(m_frames == 0 || !decode()) {
+                m_valid = false;
+                return false;
+            }
+            m_frames = 0;
+        }
+
+        using namespace std::chrono;
+        if(m_frames++ == 0) {
+            m_start = steady_clock::now() - nanoseconds{m_frame.timestamp};
+        }
+        if(m_pacing == ReplayPacing::Recorded) {
+            std::this_thread::sleep_until(m_start + nanoseconds{m_frame.timestamp});
+        }
+        return true;
+    }
+
+    bool InputReplay::decode() {
+        Reader header{ m_file.data().subspan(m_offset) };
+        uint32_t size{};
+        if(!header.read(size) || m_offset + sizeof(size) + size > m_file.size()) {
+            return false;
+        }
+
+        auto& frame = m_frame;
+        uint8_t shouldRender{};
+        Reader reader{ m_file.data().subspan(m_offset + sizeof(size), size) };
+        const bool decoded = reader.read(frame.timestamp)
+                && reader.read(frame.predictedDisplayTime)
+                && reader.read(frame.predictedDisplayPeriod)
+                && reader.read(shouldRender)
+                && reader.read(frame.viewStateFlags)
+                && reader.read(frame.viewCount) && frame.viewCount <= FrameSnapshot::MaxViews
+                && reader.read(std::span{ frame.views.data(), frame.viewCount })
+                && reader.read(frame.spaceCount) && frame.spaceCount <= FrameSnapshot::MaxSpaces
+                && reader.read(frame.spacesLocated)
+                && reader.read(std::span{ frame.spaces.data(), frame.spaceCount })
+                && reader.read(frame.actionCount) && frame.actionCount <= FrameSnapshot::MaxActions
+                && reader.read(std::span{ frame.actions.data(), frame.actionCount });
+
+        if(!decoded) {
+            frame.clear();
+            return false;
+        }
+        frame.shouldRender = shouldRender != 0;
+        m_offset += sizeof(size) + size;
+        return true;
+    }
+}
@@ -0,0 +1,160 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#define XR_USE_PLATFORM_WIN32
+#else
+#include <ctime>
+#define XR_USE_TIMESPEC
+#endif
+
+#include "check.hpp"
+#include "vr/InputSampler.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cmath>
+
+namespace vr {
+
+    namespace {
+#ifdef _WIN32
+        constexpr cstring TimeConversionFunction = "xrConvertWin32PerformanceCounterToTimeKHR";
+        constexpr cstring TimeConversionExtension = "XR_KHR_win32_convert_performance_counter_time";
+#else
+        constexpr cstring TimeConversionFunction = "xrConvertTimespecTimeToTimeKHR";
+        constexpr cstring TimeConversionExtension = "XR_KHR_convert_timespec_time";
+#endif
+
+        int64_t steadyNanoseconds() {
+            using namespace std::chrono;
+            return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+        }
+    }
+
+    void InputSamplingStats::report(double targetInterval, std::chrono::seconds reportInterval) {
+        const auto now = Clock::now();
+        if(now - lastReport < reportInterval) return;
+
+        if(samples > 0) {
+            const auto meanInterval = intervals > 0 ? interval / static_cast<double>(intervals) : 0.0;
+            const auto variance = intervals > 0 ? intervalSquared / static_cast<double>(intervals) - meanInterval * meanInterval : 0.0;
+            spdlog::debug("input sampling: {} samples, {} dropped, latency to display avg {:.2f} ms max {:.2f} ms, interval {:.3f} ms (target {:.3f} ms), jitter {:.3f} ms"
+                          , samples, dropped, latency / static_cast<double>(samples), maxLatency
+                          , meanInterval, targetInterval, std::sqrt(std::max(variance, 0.0)));
+        }
+
+        *this = InputSamplingStats{};
+        lastReport = now;
+    }
+
+    InputSampler::~InputSampler() {
+        stop();
+    }
+
+    void InputSampler::init(const Context &context, XrSpace baseSpace, std::vector<Source> sources) {
+        m_instance = context.instance;
+        m_baseSpace = baseSpace;
+        m_sources = std::move(sources);
+        m_convertTime = nullptr;
+
+        if(context.isEnabled(TimeConversionExtension)
+            && XR_FAILED(xrGetInstanceProcAddr(context.instance, TimeConversionFunction, &m_convertTime))) {
+            m_convertTime = nullptr;
+        }
+        if(!m_convertTime) {
+            spdlog::info("{} not available, input samples will be located at the predicted display time", TimeConversionExtension);
+        }
+    }
+
+    void InputSampler::start(uint32_t rate) {
+        assert(!running() && rate > 0);
+        if(m_sources.empty()) {
+            spdlog::info("no pose actions to sample");
+            return;
+        }
+        m_period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>{1.0 / rate});
+        m_thread = std::jthread{ [this](std::stop_token stopToken){ run(stopToken); } };
+        spdlog::info("input sampling thread started, sampling {} poses at {} Hz", m_sources.size(), rate);
+    }
+
+    void InputSampler::stop() {
+        if(!running()) return;
+
+        m_thread.request_stop();
+        m_thread.join();
+        m_thread = {};
+        spdlog::info("input sampling thread stopped");
+    }
+
+    void InputSampler::frame(const XrFrameState &frameState) {
+        m_displayTimeOffset.store(frameState.predictedDisplayTime - steadyNanoseconds(), std::memory_order_relaxed);
+    }
+
+    void InputSampler::report() {
+        m_stats.dropped += m_dropped.exchange(0, std::memory_order_relaxed);
+        m_stats.report(std::chrono::duration<double, std::milli>(m_period).count());
+    }
+
+    XrTime InputSampler::now() const {
+        XrTime time{};
+        if(m_convertTime) {
+#ifdef _WIN32
+            LARGE_INTEGER counter{};
+            QueryPerformanceCounter(&counter);
+            auto convert = reinterpret_cast<PFN_xrConvertWin32PerformanceCounterToTimeKHR>(m_convertTime);
+            if(XR_SUCCEEDED(convert(m_instance, &counter, &time))) {
+                return time;
+            }
+#else
+            timespec counter{};
+            clock_gettime(CLOCK_MONOTONIC, &counter);
+            auto convert = reinterpret_cast<PFN_xrConvertTimespecTimeToTimeKHR>(m_convertTime);
+            if(XR_SUCCEEDED(convert(m_instance, &counter, &time))) {
+                return time;
+            }
+#endif
+        }
+        const auto offset = m_displayTimeOffset.load(std::memory_order_relaxed);
+        return offset == 0 ? 0 : steadyNanoseconds() + offset;
+    }
+
+    void InputSampler::run(std::stop_token stopToken) {
+        constexpr XrSpaceLocationFlags located = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+        constexpr XrSpaceVelocityFlags moving = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+
+        auto next = Clock::now();
+        while(!stopToken.stop_requested()) {
+            next += m_period;
+
+            // without a time source there is nothing to locate at until the first frame
+            if(const auto time = now(); time != 0) {
+                const auto sampledAt = steadyNanoseconds();
+                for(const auto& source : m_sources) {
+                    PoseSample sample{ source.actionSet, source.action, source.spaceId, time, sampledAt };
+                    auto velocity = makeStruct<XrSpaceVelocity>();
+                    auto location = makeStruct<XrSpaceLocation>();
+                    location.next = &velocity;
+                    if(XR_SUCCEEDED(xrLocateSpace(source.space, m_baseSpace, time, &location))) {
+                        sample.isLocated = (location.locationFlags & located) == located;
+                        sample.pose = convert(location.pose);
+                        sample.hasVelocity = (velocity.velocityFlags & moving) == moving;
+                        sample.linearVelocity = { velocity.linearVelocity.x, velocity.linearVelocity.y, velocity.linearVelocity.z };
+                        sample.angularVelocity = { velocity.angularVelocity.x, velocity.angularVelocity.y, velocity.angularVelocity.z };
+                    }
+                    if(!m_samples.tryPush(sample)) {
+                        m_dropped.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+
+            std::this_thread::sleep_until(next);
+
+            // after falling behind, e.g. while the process was suspended, resume at the rate instead of catching up
+            if(const auto current = Clock::now(); current - next > m_period) {
+                next = current;
+            }
+        }
+    }
+}
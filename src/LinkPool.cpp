@@ -0,0 +1,80 @@
+#include "check.hpp"
+#include "vr/graphics/vulkan/LinkPool.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <bit>
+
+namespace vr {
+
+    void LinkPoolStats::log(const char *label) const {
+        using namespace std::chrono;
+        const auto overhead = requestedBytes > 0 ? static_cast<double>(reservedBytes) / static_cast<double>(requestedBytes) : 0.0;
+        const auto perAllocation = allocations > 0 ? duration<double, std::micro>(allocationTime).count() / static_cast<double>(allocations) : 0.0;
+        spdlog::info("links[{}]: {} live in {} blocks and {} dedicated buffers, {} KB requested, {} KB reserved ({:.2f}x), {} allocations, {:.2f} us each"
+                     , label, links, blocks, dedicated, requestedBytes / 1024, reservedBytes / 1024, overhead
+                     , allocations, perAllocation);
+    }
+
+    void LinkPool::init(VkDeviceSize alignment, CreateBlock createBlock) {
+        assert(std::has_single_bit(alignment) && alignment <= MaxSlotSize);
+        m_alignment = alignment;
+        m_createBlock = std::move(createBlock);
+
+        m_sizeClasses.clear();
+        for(auto slotSize = alignment; slotSize <= MaxSlotSize; slotSize *= 2) {
+            auto& sizeClass = m_sizeClasses.emplace_back();
+            sizeClass.slotSize = slotSize;
+            sizeClass.slotsPerBlock = static_cast<uint32_t>(BlockSize / slotSize);
+        }
+        spdlog::info("link pool initialized with {} size classes from {} to {} bytes in {} KB blocks"
+                     , m_sizeClasses.size(), alignment, MaxSlotSize, BlockSize / 1024);
+    }
+
+    uint32_t LinkPool::sizeClassOf(VkDeviceSize size) const {
+        const auto slots = (std::max(size, VkDeviceSize{1}) + m_alignment - 1) / m_alignment;
+        return static_cast<uint32_t>(std::bit_width(std::bit_ceil(slots)) - 1);
+    }
+
+    LinkAllocation LinkPool::allocate(VkDeviceSize size) {
+        assert(size <= MaxSlotSize);
+        const auto start = LinkPoolStats::Clock::now();
+
+        const auto classIndex = sizeClassOf(size);
+        auto& sizeClass = m_sizeClasses[classIndex];
+        if(sizeClass.freeSlots.empty()) {
+            const auto block = static_cast<uint32_t>(sizeClass.blocks.size());
+            sizeClass.blocks.push_back(m_createBlock(BlockSize));
+
+            // lowest slots are handed out first
+            const auto first = block * sizeClass.slotsPerBlock;
+            for(auto slot = sizeClass.slotsPerBlock; slot > 0; --slot) {
+                sizeClass.freeSlots.push_back(first + slot - 1);
+            }
+            ++m_stats.blocks;
+            m_stats.reservedBytes += BlockSize;
+        }
+
+        const auto index = sizeClass.freeSlots.back();
+        sizeClass.freeSlots.pop_back();
+
+        const auto& block = sizeClass.blocks[index / sizeClass.slotsPerBlock];
+        const auto offset = (index % sizeClass.slotsPerBlock) * sizeClass.slotSize;
+
+        ++m_stats.links;
+        ++m_stats.allocations;
+        m_stats.requestedBytes += size;
+        m_stats.allocationTime += LinkPoolStats::Clock::now() - start;
+
+        return { block._, offset, size, static_cast<std::byte*>(block.mapped) + offset, { classIndex, index, size, {} } };
+    }
+
+    void LinkPool::free(const LinkSlot &slot) {
+        assert(!slot.dedicated.valid());
+        auto& sizeClass = m_sizeClasses[slot.sizeClass];
+        sizeClass.freeSlots.push_back(slot.index);
+        --m_stats.links;
+        m_stats.requestedBytes -= slot.size;
+    }
+}
@@ -0,0 +1,97 @@
+#include "util/MappedFile.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace util {
+
+    MappedFile::MappedFile(const std::filesystem::path &path) {
+#ifdef _WIN32
+        auto file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if(file == INVALID_HANDLE_VALUE) {
+            spdlog::error("unable to open {}", path.string());
+            return;
+        }
+        LARGE_INTEGER size{};
+        GetFileSizeEx(file, &size);
+        if(size.QuadPart == 0) {
+            CloseHandle(file);
+            return;
+        }
+        auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if(!mapping) {
+            spdlog::error("unable to map {}", path.string());
+            CloseHandle(file);
+            return;
+        }
+        m_file = file;
+        m_mapping = mapping;
+        m_data = static_cast<const std::byte*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        m_size = static_cast<size_t>(size.QuadPart);
+#else
+        auto fd = open(path.c_str(), O_RDONLY);
+        if(fd < 0) {
+            spdlog::error("unable to open {}", path.string());
+            return;
+        }
+        struct stat info{};
+        if(fstat(fd, &info) == 0 && info.st_size > 0) {
+            auto data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if(data != MAP_FAILED) {
+                m_data = static_cast<const std::byte*>(data);
+                m_size = static_cast<size_t>(info.st_size);
+                madvise(data, m_size, MADV_SEQUENTIAL);
+            }else {
+                spdlog::error("unable to map {}", path.string());
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    MappedFile::MappedFile(MappedFile &&source) noexcept {
+        *this = std::move(source);
+    }
+
+    MappedFile &MappedFile::operator=(MappedFile &&source) noexcept {
+        if(this != &source) {
+            close();
+            m_data = std::exchange(source.m_data, nullptr);
+            m_size = std::exchange(source.m_size, 0);
+#ifdef _WIN32
+            m_file = std::exchange(source.m_file, nullptr);
+            m_mapping = std::exchange(source.m_mapping, nullptr);
+#endif
+        }
+        return *this;
+    }
+
+    MappedFile::~MappedFile() {
+        close();
+    }
+
+    void MappedFile::close() {
+#ifdef _WIN32
+        if(m_data) UnmapViewOfFile(m_data);
+        if(m_mapping) CloseHandle(m_mapping);
+        if(m_file) CloseHandle(m_file);
+        m_mapping = m_file = nullptr;
+#else
+        if(m_data) munmap(const_cast<std::byte*>(m_data), m_size);
+#endif
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
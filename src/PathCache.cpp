@@ -0,0 +1,21 @@
+#include "vr/PathCache.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace vr {
+
+    XrPath PathCache::operator()(std::string_view path) {
+        if(auto itr = m_paths.find(path); itr != m_paths.end()) {
+            return itr->second;
+        }
+
+        XrPath xrPath{XR_NULL_PATH};
+        std::string key{path};
+        if(auto result = xrStringToPath(m_instance, key.c_str(), &xrPath); XR_FAILED(result)) {
+            spdlog::warn("{} is not a valid path, result: {}", key, static_cast<int>(result));
+            xrPath = XR_NULL_PATH;
+        }
+        m_paths.emplace(std::move(key), xrPath);
+        return xrPath;
+    }
+}
@@ -0,0 +1,118 @@
+#include "check.hpp"
+#include "vr/graphics/vulkan/PipelineCache.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <vector>
+
+namespace vr {
+
+    void PipelineCacheStats::log(const char *label) const {
+        using namespace std::chrono;
+        spdlog::info("pipeline cache[{}]: {} start ({} KB loaded), {} pipelines created in {:.2f} ms"
+                     , label, warm ? "warm" : "cold", loadedBytes / 1024, pipelines
+                     , duration<double, std::milli>(creationTime).count());
+    }
+
+    void PipelineCache::init(VkDevice device, const VkPhysicalDeviceProperties &properties, const std::filesystem::path &directory) {
+        m_device = device;
+        m_properties = properties;
+        m_stats = {};
+
+        std::string uuid;
+        for(auto byte : properties.pipelineCacheUUID) {
+            uuid += std::format("{:02x}", byte);
+        }
+        m_path = directory / std::format("{:04x}_{:04x}_{}_{:08x}.bin", properties.vendorID, properties.deviceID, uuid, properties.driverVersion);
+
+        std::vector<char> data;
+        if(std::ifstream in{ m_path, std::ios::binary }; in) {
+            FileHeader header{};
+            in.read(reinterpret_cast<char*>(&header), sizeof(header));
+            std::error_code error;
+            const auto fileSize = std::filesystem::file_size(m_path, error);
+            if(in && !error && header.magic == Magic && header.version == Version && header.driverVersion == properties.driverVersion
+                && header.dataSize == fileSize - sizeof(header)) {
+                data.resize(header.dataSize);
+                in.read(data.data(), static_cast<std::streamsize>(data.size()));
+                if(!in || !validate(data)) {
+                    spdlog::warn("discarding invalid pipeline cache {}", m_path.string());
+                    data.clear();
+                }
+            }
+        }
+
+        auto createInfo = makeStruct<VkPipelineCacheCreateInfo>();
+        createInfo.initialDataSize = data.size();
+        createInfo.pInitialData = data.empty() ? nullptr : data.data();
+        if(vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache) != VK_SUCCESS && !data.empty()) {
+            // the driver may still reject data that passed validation, start over with an empty cache
+            spdlog::warn("driver rejected pipeline cache {}", m_path.string());
+            data.clear();
+            createInfo.initialDataSize = 0;
+            createInfo.pInitialData = nullptr;
+            CHECK_VULKAN(vkCreatePipelineCache(m_device, &createInfo, nullptr, &m_cache));
+        }
+
+        m_stats.warm = !data.empty();
+        m_stats.loadedBytes = data.size();
+        spdlog::info("pipeline cache {}, {} KB from {}", m_stats.warm ? "loaded" : "empty", data.size() / 1024, m_path.string());
+    }
+
+    bool PipelineCache::validate(const std::vector<char> &data) const {
+        VkPipelineCacheHeaderVersionOne header{};
+        if(data.size() < sizeof(header)) return false;
+
+        std::memcpy(&header, data.data(), sizeof(header));
+        return header.headerSize >= sizeof(header)
+            && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+            && header.vendorID == m_properties.vendorID
+            && header.deviceID == m_properties.deviceID
+            && std::memcmp(header.pipelineCacheUUID, m_properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+    void PipelineCache::save() {
+        if(!m_cache) return;
+
+        size_t size{};
+        CHECK_VULKAN(vkGetPipelineCacheData(m_device, m_cache, &size, nullptr));
+        std::vector<char> data(size);
+        CHECK_VULKAN(vkGetPipelineCacheData(m_device, m_cache, &size, data.data()));
+        data.resize(size);
+
+        std::error_code error;
+        std::filesystem::create_directories(m_path.parent_path(), error);
+
+        auto temporary = m_path;
+        temporary += ".tmp";
+        {
+            std::ofstream out{ temporary, std::ios::binary | std::ios::trunc };
+            const FileHeader header{ Magic, Version, m_properties.driverVersion, 0, data.size() };
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(data.data(), static_cast<std::streamsize>(data.size()));
+            if(!out.flush()) {
+                spdlog::warn("unable to write pipeline cache {}", temporary.string());
+                return;
+            }
+        }
+
+        std::filesystem::rename(temporary, m_path, error);
+        if(error) {
+            spdlog::warn("unable to replace pipeline cache {}, {}", m_path.string(), error.message());
+            std::filesystem::remove(temporary, error);
+            return;
+        }
+        spdlog::info("saved {} KB pipeline cache to {}", data.size() / 1024, m_path.string());
+    }
+
+    void PipelineCache::destroy() {
+        if(m_cache) {
+            vkDestroyPipelineCache(m_device, m_cache, nullptr);
+            m_cache = VK_NULL_HANDLE;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#include "vr/PoseHistory.hpp"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+
+namespace vr {
+
+    namespace {
+        constexpr double NanosecondsToSeconds{1E-9};
+
+        Pose integrate(const Pose& pose, const glm::vec3& linearVelocity, const glm::vec3& angularVelocity, double seconds) {
+            Pose result{ pose.orientation, pose.position + linearVelocity * static_cast<float>(seconds) };
+            const auto speed = glm::length(angularVelocity);
+            if(speed > 1E-6f) {
+                const auto rotation = glm::angleAxis(speed * static_cast<float>(seconds), angularVelocity / speed);
+                result.orientation = glm::normalize(rotation * pose.orientation);
+            }
+            return result;
+        }
+    }
+
+    void PoseHistory::record(SpaceId space, const TimedPose &sample) {
+        if(space >= m_spaces.size()) return;
+
+        auto& ring = m_spaces[space];
+
+        // samples mostly arrive in order, walk back from the newest to find where this one goes
+        auto position = ring.count;
+        while(position > 0 && ring[position - 1].time > sample.time) {
+            --position;
+        }
+        if(position > 0 && ring[position - 1].time == sample.time) {
+            ring[position - 1] = sample;
+            return;
+        }
+        if(ring.count == Capacity) {
+            if(position == 0) return;   // older than everything kept
+
+            ring.start = (ring.start + 1) % Capacity;
+            --ring.count;
+            --position;
+        }
+        for(auto i = ring.count; i > position; --i) {
+            ring[i] = ring[i - 1];
+        }
+        ring[position] = sample;
+        ++ring.count;
+    }
+
+    std::optional<TimedPose> PoseHistory::latest(SpaceId space) const {
+        if(size(space) == 0) return {};
+        const auto& ring = m_spaces[space];
+        return ring[ring.count - 1];
+    }
+
+    std::optional<Pose> PoseHistory::at(SpaceId space, XrTime time) const {
+        if(size(space) == 0) return {};
+
+        const auto& ring = m_spaces[space];
+        if(time <= ring[0].time) {
+            return ring[0].pose;
+        }
+        if(time >= ring[ring.count - 1].time) {
+            return extrapolate(ring, time);
+        }
+
+        auto upper = ring.count - 1;
+        while(ring[upper - 1].time > time) {
+            --upper;
+        }
+        const auto& from = ring[upper - 1];
+        const auto& to = ring[upper];
+        const auto t = static_cast<float>(static_cast<double>(time - from.time) / static_cast<double>(to.time - from.time));
+        return Pose{
+            glm::slerp(from.pose.orientation, to.pose.orientation, t),
+            glm::mix(from.pose.position, to.pose.position, t)
+        };
+    }
+
+    Pose PoseHistory::extrapolate(const Ring &ring, XrTime time) {
+        const auto& newest = ring[ring.count - 1];
+        const auto seconds = static_cast<double>(std::min(time - newest.time, MaxExtrapolation)) * NanosecondsToSeconds;
+        if(seconds <= 0) {
+            return newest.pose;
+        }
+        if(newest.hasVelocity) {
+            return integrate(newest.pose, newest.linearVelocity, newest.angularVelocity, seconds);
+        }
+        if(ring.count < 2) {
+            return newest.pose;
+        }
+
+        const auto& previous = ring[ring.count - 2];
+        const auto interval = static_cast<double>(newest.time - previous.time) * NanosecondsToSeconds;
+        const auto linearVelocity = (newest.pose.position - previous.pose.position) / static_cast<float>(interval);
+
+        // rotation from previous to newest as an angular velocity around the base space axes
+        auto delta = newest.pose.orientation * glm::inverse(previous.pose.orientation);
+        if(delta.w < 0) delta = -delta;
+        const auto angle = glm::angle(delta);
+        const auto angularVelocity = angle > 1E-6f ? glm::axis(delta) * (angle / static_cast<float>(interval)) : glm::vec3{0};
+
+        return integrate(newest.pose, linearVelocity, angularVelocity, seconds);
+    }
+}
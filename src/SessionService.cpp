@@ -4,15 +4,26 @@
 #include "vr/Enumerators.hpp"
 #include "vr/ToString.hpp"
 #include "util/collections.hpp"
+#include "util/HeapGuard.hpp"
 
 #include <GLFW/glfw3.h>
 
 #include <stdexcept>
 #include <thread>
 #include <chrono>
+#include <optional>
 
 namespace vr {
 
+    static ActionState initialState(XrActionType type) {
+        switch(type) {
+            case XR_ACTION_TYPE_FLOAT_INPUT: return 0.0f;
+            case XR_ACTION_TYPE_VECTOR2F_INPUT: return glm::vec2{0};
+            case XR_ACTION_TYPE_POSE_INPUT: return Pose{};
+            default: return false;
+        }
+    }
+
     void OnHostKeyPress(GLFWwindow *window, int key, int scancode, int action, int mods) {
         auto session = reinterpret_cast<SessionService*>(glfwGetWindowUserPointer(window));
         session->handleHostKeyPress(key, scancode, action, mods);
@@ -40,12 +51,17 @@ namespace vr {
     }
 
     void SessionService::init() {
+        using namespace std::chrono;
+        const auto start = steady_clock::now();
         m_config.validate(m_ctx);
         createSession();
         createReferenceSpaces();
         createSwapChain();
         createMainViewSpace();
         setupActions();
+        m_poseHistory.resize(m_spaceLocator.size());
+        m_handTracker.init(m_ctx, m_session, m_config._handTracking);
+        createInputRecording();
         initRenderer();
 #ifdef USE_MIRROR_WINDOW
         m_graphics->initMirrorWindow();
@@ -53,9 +69,13 @@ namespace vr {
         glfwSetWindowUserPointer(window._, this);
         glfwSetKeyCallback(window._, OnHostKeyPress);
 #endif
+        setupLateLatch();
+        m_graphics->flush();
+        spdlog::info("session initialized in {:.2f} ms", duration<double, std::milli>(steady_clock::now() - start).count());
     }
 
     void SessionService::createSession() {
+        m_paths.init(m_ctx.instance);
         auto createInfo = makeStruct<XrSessionCreateInfo>();
         const auto& graphicsBinding = m_graphics->graphicsBinding();
         createInfo.systemId = m_ctx.systemId;
@@ -64,6 +84,8 @@ namespace vr {
     }
 
     void SessionService::createReferenceSpaces() {
+        m_spaceLocator.init(m_ctx, m_session);
+
         for(const auto& spec : m_config._spaces) {
             auto createInfo = makeStruct<XrReferenceSpaceCreateInfo>();
             createInfo.referenceSpaceType = spec._referenceSpaceType;
@@ -72,11 +94,17 @@ namespace vr {
             XrSpace space;
             CHECK_XR(xrCreateReferenceSpace(m_session, &createInfo, &space));
 
-            m_spaces.insert(std::make_pair(spec._name, space));
+            m_spaceLocator.add(space, spec._name);
         }
     }
     
     void SessionService::createMainViewSpace() {
+        const auto numViews = m_ctx.views(XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO).size();
+        if(numViews > MaxViews) {
+            THROW(std::format("view configuration has {} views, at most {} supported", numViews, MaxViews));
+        }
+        m_views.fill(makeStruct<XrView>());
+
         auto createInfo = makeStruct<XrReferenceSpaceCreateInfo>();
         createInfo.referenceSpaceType = m_config._baseSpaceType;
         createInfo.poseInReferenceSpace.position = {0, 0, 0};
@@ -84,7 +112,97 @@ namespace vr {
         LOG_ERROR(m_ctx.instance, xrCreateReferenceSpace(m_session, &createInfo, &m_baseSpace))
     }
 
+    void SessionService::createInputRecording() {
+        if(!m_config._replayInput.empty()) {
+            const auto pacing = m_config._replayPaced ? ReplayPacing::Recorded : ReplayPacing::AsFastAsPossible;
+            m_replay = std::make_unique<InputReplay>(m_config._replayInput, pacing);
+        }
+        if(!m_config._recordOutput.empty()) {
+            m_recorder = std::make_unique<InputRecorder>(m_config._recordOutput);
+        }
+    }
+
+    void SessionService::updateInputSampler() {
+        m_inputSampler.stop();
+        if(m_config._inputSampleRate == 0 || m_currentState != XR_SESSION_STATE_FOCUSED) return;
+
+        std::vector<InputSampler::Source> sources;
+        for(const auto& binding : m_actionSetBindings) {
+            if(!binding.active) continue;
+
+            for(ActionId id = 0; id < binding.actions.size(); ++id) {
+                if(binding.actions[id].type == XR_ACTION_TYPE_POSE_INPUT) {
+                    const auto space = binding.actions[id].space;
+                    sources.push_back({ binding.actionSet.id, id, space, m_spaceLocator.space(space) });
+                }
+            }
+        }
+        m_inputSampler.init(m_ctx, m_baseSpace, std::move(sources));
+        m_inputSampler.start(m_config._inputSampleRate);
+    }
+
+    void SessionService::setupLateLatch() {
+        m_latchLocator.init(m_ctx, m_session);
+        for(SpaceId id = 0; id < m_spaceLocator.size(); ++id) {
+            m_latchLocator.add(m_spaceLocator.space(id), m_spaceLocator.name(id));
+        }
+        m_graphics->beforeSubmit([this]{ lateLatch(); });
+    }
+
+    void SessionService::lateLatch() {
+        auto target = m_renderer->lateLatchTarget();
+        if(!target || m_latchTime == 0 || replayFrame()) return;
+
+        std::array<XrView, MaxViews> views{};
+        views.fill(makeStruct<XrView>());
+        auto viewState = makeStruct<XrViewState>();
+        auto viewLocateInfo = makeStruct<XrViewLocateInfo>();
+        viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        viewLocateInfo.displayTime = m_latchTime;
+        viewLocateInfo.space = m_baseSpace;
+
+        uint32_t viewCount{};
+        if(XR_SUCCEEDED(xrLocateViews(m_session, &viewLocateInfo, &viewState, views.size(), &viewCount, views.data()))) {
+            target->viewCount = std::min(viewCount, LatchedPoses::MaxViews);
+            for(auto i = 0u; i < target->viewCount; ++i) {
+                target->views[i] = glm::inverse(toMatrix(views[i].pose));
+            }
+        }
+
+        // the frame's spaces are located again into a locator of their own, the frame's poses were recorded
+        // and handed to the renderer already. Spaces that are not located keep the pose the frame was recorded with
+        m_latchLocator.clearRequired();
+        m_latchLocator.require(m_spaceLocator.required());
+        m_latchLocator.locate(m_baseSpace, m_latchTime);
+        target->spaceCount = std::min(static_cast<uint32_t>(m_spaceLocator.size()), LatchedPoses::MaxSpaces);
+        for(SpaceId id = 0; id < target->spaceCount; ++id) {
+            target->spaces[id] = toMatrix(m_spaceLocator.pose(id));
+        }
+        for(const auto id : m_latchLocator.required()) {
+            if(!m_latchLocator.isLocated(id)) continue;
+
+            const auto pose = m_latchLocator.pose(id);
+            if(id < target->spaceCount) {
+                target->spaces[id] = toMatrix(pose);
+            }
+
+            // the fresher prediction for the same display time replaces the frame's sample
+            const auto& velocity = m_latchLocator.velocity(id);
+            m_poseHistory.record(id, { m_latchTime, pose
+                                       , { velocity.linearVelocity.x, velocity.linearVelocity.y, velocity.linearVelocity.z }
+                                       , { velocity.angularVelocity.x, velocity.angularVelocity.y, velocity.angularVelocity.z }
+                                       , m_latchLocator.hasVelocity(id) });
+        }
+    }
+
     void SessionService::initRenderer() {
+        m_renderer->frameMemory(&m_frameArena);
+        m_renderer->profiler(&m_profiler);
+        m_renderer->poseHistory(&m_poseHistory);
+        m_renderer->bind(m_spaceLocator);
+        for(const auto& actionSet : m_actionSets) {
+            m_renderer->bind(actionSet);
+        }
         m_renderer->init();
     }
 
@@ -129,6 +247,10 @@ namespace vr {
     }
     
     void SessionService::stop() {
+        stopFramePacer();
+        m_inputSampler.stop();
+        m_recorder.reset();
+        m_handTracker.destroy();
         transitionTo(XR_SESSION_STATE_LOSS_PENDING);
         xrDestroySession(m_session);
     }
@@ -136,7 +258,24 @@ namespace vr {
     void SessionService::transitionTo(XrSessionState state) {
         if(state == XR_SESSION_STATE_UNKNOWN) throw cpptrace::runtime_error{"Invalid state"};
         spdlog::debug("transitioning session state from {} to {}", toString(m_currentState), toString(state));
+        const auto wasFocused = m_currentState == XR_SESSION_STATE_FOCUSED;
         m_currentState = state;
+
+        // actions only update while focused, sampling them in any other state is wasted work
+        if(wasFocused != (state == XR_SESSION_STATE_FOCUSED)) {
+            updateInputSampler();
+        }
+    }
+
+    void SessionService::stopFramePacer() {
+        m_framePacer.stop([this](const XrFrameState& frameState){
+            if(XR_SUCCEEDED(xrBeginFrame(m_session, nullptr))) {
+                auto endFrameInfo = makeStruct<XrFrameEndInfo>();
+                endFrameInfo.environmentBlendMode = m_blendMode;
+                endFrameInfo.displayTime = frameState.predictedDisplayTime;
+                xrEndFrame(m_session, &endFrameInfo);
+            }
+        });
     }
 
     bool SessionService::imageFormatIsSupported(uint64_t format) {
@@ -149,6 +288,15 @@ namespace vr {
         if(action == GLFW_RELEASE && key == GLFW_KEY_ESCAPE) {
             terminate();
         }
+        if(action == GLFW_RELEASE && key == GLFW_KEY_F12) {
+            dumpProfile();
+        }
+    }
+
+    void SessionService::dumpProfile() const {
+        if(m_profiler.frames() == 0) return;
+        m_profiler.log();
+        m_profiler.write(m_config._profileOutput);
     }
 
     void SessionService::terminate() {
@@ -161,6 +309,9 @@ namespace vr {
             return;
         }
         std::vector<XrActionSet> actionSets;
+
+        // bindings refer to their action set, so it must not be reallocated
+        m_actionSets.reserve(m_config._actionSets.size());
         for(const auto& spec : m_config._actionSets) {
             auto createInfo = makeStruct<XrActionSetCreateInfo>();
             strcpy_s(createInfo.actionSetName, spec._name.c_str());
@@ -172,8 +323,10 @@ namespace vr {
             CHECK_XR(xrCreateActionSet(m_ctx.instance, &createInfo, &actionSet));
             actionSets.push_back(actionSet);
 
-            m_actionSets.emplace_back();
-            m_actionSetBindings.push_back({actionSet, m_actionSets.back()});
+            auto& states = m_actionSets.emplace_back();
+            states.name = spec._name;
+            states.id = static_cast<ActionSetId>(m_actionSets.size() - 1);
+            m_actionSetBindings.push_back({actionSet, states});
             ActionSetBinding& binding = m_actionSetBindings.back();
 
             for(const auto& actionSpec : spec._actions) {
@@ -185,6 +338,12 @@ namespace vr {
                 XrAction action;
                 CHECK_XR(xrCreateAction(actionSet, &actionInfo, &action));
 
+                const auto id = binding.actionSet.add(actionSpec.name, initialState(actionInfo.actionType));
+                assert(id == binding.actions.size());
+                binding.actions.push_back({actionSpec.input, action, actionInfo.actionType});
+                binding.changed.reserve(binding.actions.size());
+                auto& data = binding.actions.back();
+
                 if (actionInfo.actionType == XR_ACTION_TYPE_POSE_INPUT) {
                     auto spaceInfo = makeStruct<XrActionSpaceCreateInfo>();
                     spaceInfo.action = action;
@@ -192,25 +351,17 @@ namespace vr {
                     spaceInfo.poseInActionSpace.orientation = {0, 0, 0, 1};
                     XrSpace space;
                     xrCreateActionSpace(m_session, &spaceInfo, &space);
-                    m_actionSpaces[actionSpec.name] = space;
+                    data.space = m_spaceLocator.add(space);
+                    m_poseHistory.bind(states.id, id, data.space);
                 }
-
-                binding.actions[actionSpec.name] = {actionSpec.input, action};
-                binding.actionSet.actions[actionSpec.name] = {actionSpec.name, false};
             }
         }
 
-        const auto activeSets = m_renderer->activeActionSets();
-        if(activeSets == "*"){
-            for(auto actionSet : actionSets){
-                m_activeActionSets.push_back({ actionSet, XR_NULL_PATH});
-            }
-        }else {
-            // TODO filter setA/SetB/SetC
-        }
+        m_poseThreshold = { m_config._poseChangeDistance, std::cos(glm::radians(m_config._poseChangeAngle) * 0.5f) };
+        m_activeActionSets.reserve(m_actionSetBindings.size());
+        activateActionSets();
 
-//        bindActions(InteractionProfile::Simple());
-        bindActions(InteractionProfile::OculusTouchController());
+        bindActions();
 
         auto attachInfo = makeStruct<XrSessionActionSetsAttachInfo>();
         attachInfo.countActionSets = actionSets.size();
@@ -218,110 +369,254 @@ namespace vr {
         LOG_ERROR(m_ctx.instance, xrAttachSessionActionSets(m_session, &attachInfo));
     }
 
-    void SessionService::bindActions(const InteractionProfile &profile) {
-        std::vector<XrActionSuggestedBinding> actionSuggestedBinding;
+    void SessionService::activateActionSets() {
+        m_activeActionSetsVersion = m_renderer->activeActionSetsVersion();
+        const auto names = m_renderer->activeActionSets();
+        const auto all = names == "*";
 
-        for(const auto& actionSetBinding : m_actionSetBindings ) {
-            for(auto [_, action] : actionSetBinding.actions) {
-                auto sPath = profile.path(action.input);
-                if(sPath.has_value()) {
-                    XrPath path;
-                    CHECK_XR(xrStringToPath(m_ctx.instance, sPath->c_str(), &path));
-                    auto &binding = push_use(actionSuggestedBinding);
-                    binding.action = action._;
-                    binding.binding = path;
+        auto listed = [&](std::string_view name) {
+            for(std::string_view remaining{names}; !remaining.empty();) {
+                const auto end = std::min(remaining.find('/'), remaining.size());
+                if(remaining.substr(0, end) == name) return true;
+                remaining.remove_prefix(std::min(end + 1, remaining.size()));
+            }
+            return false;
+        };
+
+        m_activeActionSets.clear();
+        m_poseActionSpaces.clear();
+        for(auto& binding : m_actionSetBindings) {
+            const auto active = all || listed(binding.actionSet.name);
+            if(binding.active && !active) {
+                // states of a set that is no longer synchronized would otherwise keep their last values
+                for(auto& action : binding.actionSet) {
+                    action.isActive = false;
+                    action.changed = false;
+                }
+            }
+            binding.active = active;
+            if(active) {
+                m_activeActionSets.push_back({ binding.xrActionSet, XR_NULL_PATH });
+                for(const auto& action : binding.actions) {
+                    if(action.type == XR_ACTION_TYPE_POSE_INPUT) {
+                        m_poseActionSpaces.push_back(action.space);
+                    }
                 }
             }
         }
+        if(m_currentState == XR_SESSION_STATE_FOCUSED) {
+            updateInputSampler();
+        }
+        spdlog::info("{} of {} action sets active: {}", m_activeActionSets.size(), m_actionSetBindings.size(), names);
+    }
 
-        XrPath xrProfile;
-        xrStringToPath(m_ctx.instance, profile.profile().c_str(), &xrProfile);
+    void SessionService::bindActions() {
+        std::vector<XrActionSuggestedBinding> actionSuggestedBinding;
+        auto suggested = 0u;
 
-        auto suggestedBindings = makeStruct<XrInteractionProfileSuggestedBinding>();
-        suggestedBindings.interactionProfile = xrProfile;
-        suggestedBindings.countSuggestedBindings = actionSuggestedBinding.size();
-        suggestedBindings.suggestedBindings = actionSuggestedBinding.data();
-        LOG_ERROR(m_ctx.instance, xrSuggestInteractionProfileBindings(m_ctx.instance, &suggestedBindings));
+        for(const auto& profile : m_config._interactionProfiles) {
+            actionSuggestedBinding.clear();
+            for(const auto& actionSetBinding : m_actionSetBindings) {
+                for(const auto& action : actionSetBinding.actions) {
+                    if(!profile.supports(action.input)) continue;
 
+                    if(auto path = m_paths(*profile.path(action.input)); path != XR_NULL_PATH) {
+                        actionSuggestedBinding.push_back({ action._, path });
+                    }
+                }
+            }
+            if(actionSuggestedBinding.empty()) continue;
+
+            auto suggestedBindings = makeStruct<XrInteractionProfileSuggestedBinding>();
+            suggestedBindings.interactionProfile = m_paths(profile.profile());
+            suggestedBindings.countSuggestedBindings = actionSuggestedBinding.size();
+            suggestedBindings.suggestedBindings = actionSuggestedBinding.data();
+
+            // a runtime that does not know a profile rejects its bindings, the other profiles can still be used
+            if(auto result = xrSuggestInteractionProfileBindings(m_ctx.instance, &suggestedBindings); XR_FAILED(result)) {
+                spdlog::warn("bindings for {} not accepted, result: {}", profile.profile(), static_cast<int>(result));
+            }else {
+                ++suggested;
+            }
+        }
+        spdlog::info("suggested bindings for {} of {} interaction profiles, {} paths interned"
+                     , suggested, m_config._interactionProfiles.size(), m_paths.size());
     }
 
 
 
     void SessionStateRunning::beginFrame() {
+        {
+            util::HeapGuardPause driver;
+            m_sessionService.m_graphics->beginFrame();
+        }
         m_sessionService.m_renderer->beginFrame();
     }
 
+    bool SessionStateRunning::waitFrame() {
+        auto& framePacer = m_sessionService.m_framePacer;
+        if(framePacer.running()) {
+            return framePacer.next(m_frameState);
+        }
+        return XR_SUCCEEDED(xrWaitFrame(m_sessionService.m_session, XR_NULL_HANDLE, &m_frameState));
+    }
+
     void SessionStateRunning::processFrame() {
+        using Clock = FramePacingStats::Clock;
+
         if(state() == XR_SESSION_STATE_UNKNOWN) {
             throw cpptrace::runtime_error{"Invalid state"};
         }
 
-        static std::vector<Layer> layers;
-        layers.clear();
-
+        auto& frameArena = m_sessionService.m_frameArena;
+        auto& profiler = m_sessionService.m_profiler;
         const auto session = m_sessionService.m_session;
         const auto& swapchains = m_sessionService.m_swapchains;
 
-        xrWaitFrame(session, XR_NULL_HANDLE, &m_frameState);
+        const auto frameStart = Clock::now();
+        if(!waitFrame()) {
+            return;
+        }
+
+        // replayed frames keep the runtime's frame timing for xrEndFrame, the renderer sees the recorded one
+        auto recorder = m_sessionService.m_recorder.get();
+        if(auto& replay = m_sessionService.m_replay) {
+            replay->next();
+        }
+        const auto replayed = m_sessionService.replayFrame();
+        const auto displayTime = replayed ? replayed->predictedDisplayTime : m_frameState.predictedDisplayTime;
+        const auto displayPeriod = replayed ? replayed->predictedDisplayPeriod : m_frameState.predictedDisplayPeriod;
+        const auto frameWaited = Clock::now();
+        profiler.record(FrameProfiler::Wait, frameWaited - frameStart);
 
+        m_sessionService.m_latchTime = m_frameState.predictedDisplayTime;
+
+        // switching the active action sets allocates, so it has to happen before the heap guard is armed
+        if(m_sessionService.m_renderer->activeActionSetsVersion() != m_sessionService.m_activeActionSetsVersion) {
+            m_sessionService.activateActionSets();
+        }
 
+        // after warm-up every transient allocation of the frame thread's own code should come from the frame arena,
+        // the guard is paused across calls into the runtime and driver
+        const bool warmedUp = ++m_sessionService.m_frameCount > SessionService::HeapGuardWarmUpFrames;
         if(XR_SUCCEEDED(xrBeginFrame(session, nullptr))) {
+            util::HeapGuardScope heapGuard{warmedUp};
+            Layers layers{ &frameArena };
+            layers.reserve(8);
+
+            beginFrame();
+            profiler.record(FrameProfiler::Begin, Clock::now() - frameWaited);
+
+            // action spaces are located as of the last sync, so actions are synced before anything is located
+            {
+                auto phase = profiler.measure(FrameProfiler::ActionSync);
+                util::HeapGuardPause runtime;
+                syncActions();
+            }
+            {
+                auto phase = profiler.measure(FrameProfiler::SpaceLocate);
+                locateSpaces();
+
+                auto& spaceLocator = m_sessionService.m_spaceLocator;
+                if(replayed) replayed->apply(spaceLocator);
+                if(recorder) recorder->frame().capture(spaceLocator);
+            }
+            {
+                auto phase = profiler.measure(FrameProfiler::ActionSync);
+                processInput();
+
+                if(auto& sampler = m_sessionService.m_inputSampler; sampler.running()) {
+                    sampler.frame(m_frameState);
+                    std::pmr::vector<PoseSample> samples{ &frameArena };
+                    sampler.drain(m_frameState.predictedDisplayTime, [&](const PoseSample& sample){
+                        samples.push_back(sample);
+                        if(sample.isLocated) {
+                            m_sessionService.m_poseHistory.record(sample.space, { sample.time, sample.pose
+                                     , sample.linearVelocity, sample.angularVelocity, sample.hasVelocity });
+                        }
+                    });
+                    m_sessionService.m_renderer->set(std::span<const PoseSample>{ samples });
+                }
+            }
+
             if(m_frameState.shouldRender){
-                beginFrame();
 
+                auto& images = m_sessionService.m_swapChainImages;
+                uint32_t numImages = 0;
+                std::optional<FrameProfiler::Scope> acquirePhase{ std::in_place, profiler, FrameProfiler::Acquire };
+                std::optional<util::HeapGuardPause> acquireRuntime{ std::in_place };
                 for(const auto& swapchain : swapchains) {
-
                     uint32_t imageIndex;
-                    xrAcquireSwapchainImage(swapchain.handle, nullptr, &imageIndex);
-                    ImageId imageId{swapchain.handle, imageIndex};
+                    if(XR_FAILED(xrAcquireSwapchainImage(swapchain.handle, nullptr, &imageIndex))) {
+                        continue;
+                    }
                     auto waitInfo = makeStruct<XrSwapchainImageWaitInfo>();
                     waitInfo.timeout = XR_INFINITE_DURATION;
 
                     if (XR_UNQUALIFIED_SUCCESS(xrWaitSwapchainImage(swapchain.handle, &waitInfo))) {
+                        images[numImages++] = {swapchain.handle, imageIndex};
+                    }else {
+                        xrReleaseSwapchainImage(swapchain.handle, nullptr);
+                    }
+                }
 
-                        // Get view info
-                        auto viewState = makeStruct<XrViewState>();
-                        auto viewLocateInfo = makeStruct<XrViewLocateInfo>();
-                        viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
-                        viewLocateInfo.displayTime = m_frameState.predictedDisplayTime;
-                        viewLocateInfo.space = m_sessionService.m_baseSpace;
-                        uint32_t numViews;
-                        xrLocateViews(session, &viewLocateInfo, &viewState, 0, &numViews, XR_NULL_HANDLE);
-                        std::vector<XrView> views(numViews, {XR_TYPE_VIEW});
-                        LOG_ERROR(m_sessionService.m_ctx.instance,
-                                  xrLocateViews(session, &viewLocateInfo, &viewState, numViews, &numViews,
-                                                views.data()));
-                        ViewInfo viewInfo{viewState, views};
-
-                        // get space locations
-                        std::vector<SpaceLocation> spaceLocations;
-                        spaceLocations.reserve(m_sessionService.m_spaces.size());
-                        for (const auto &[name, space]: m_sessionService.m_spaces) {
-                            auto location = makeStruct<XrSpaceLocation>();
-                            xrLocateSpace(space, m_sessionService.m_baseSpace, m_frameState.predictedDisplayTime,
-                                          &location);
-                            spaceLocations.push_back({name, convert(location.pose)});
-                        }
-                        if (!spaceLocations.empty()) {
-                            m_sessionService.m_renderer->set(spaceLocations);
+                acquireRuntime.reset();
+                acquirePhase.reset();
+
+                if(numImages > 0) {
+                    {
+                        auto phase = profiler.measure(FrameProfiler::SpaceLocate);
+                        {
+                            util::HeapGuardPause runtime;
+                            locateViews();
                         }
 
-                        frameLoop({imageId, {viewState, std::move(views)}, m_sessionService.m_baseSpace,
-                                   m_frameState.predictedDisplayTime, m_frameState.predictedDisplayPeriod}, layers);
+                        auto& viewState = m_sessionService.m_viewState;
+                        std::span<XrView> located{ m_sessionService.m_views };
+                        if(replayed) replayed->apply(viewState, located, m_sessionService.m_viewCount);
+                        if(recorder) recorder->frame().capture(viewState, located.first(m_sessionService.m_viewCount));
+                    }
 
-#ifdef USE_MIRROR_WINDOW
-                        m_sessionService.m_graphics->mirror(imageId);
-#endif
+                    const auto& spaceLocator = m_sessionService.m_spaceLocator;
+                    if (!spaceLocator.required().empty()) {
+                        m_sessionService.m_renderer->set(spaceLocator);
+                    }
+                    if(const auto& handTracker = m_sessionService.m_handTracker; handTracker.enabled()) {
+                        m_sessionService.m_renderer->set(handTracker);
+                    }
 
+                    std::span<const ImageId> acquired{ images.data(), numImages };
+                    std::span<const XrView> views{ m_sessionService.m_views.data(), m_sessionService.m_viewCount };
+                    {
+                        auto phase = profiler.measure(FrameProfiler::RendererRecord);
+                        frameLoop({acquired.front(), acquired, {m_sessionService.m_viewState, views}, m_sessionService.m_baseSpace,
+                                   displayTime, displayPeriod}, layers);
                     }
-                    xrReleaseSwapchainImage(swapchain.handle, nullptr);
 
+#ifdef USE_MIRROR_WINDOW
+                    {
+                        auto phase = profiler.measure(FrameProfiler::Submit);
+                        util::HeapGuardPause driver;
+                        m_sessionService.m_graphics->mirror(acquired.front());
+                    }
+#endif
+                    auto phase = profiler.measure(FrameProfiler::Release);
+                    util::HeapGuardPause runtime;
+                    for(const auto& imageId : acquired) {
+                        xrReleaseSwapchainImage(imageId.swapChain, nullptr);
+                    }
                 }
+            }
+            {
+                auto phase = profiler.measure(FrameProfiler::Submit);
                 endFrame();
             }
 
+            auto endPhase = profiler.measure(FrameProfiler::End);
+
             std::sort(layers.begin(), layers.end());
-            std::vector<XrCompositionLayerBaseHeader*> xrLayers;
+            std::pmr::vector<XrCompositionLayerBaseHeader*> xrLayers{ &frameArena };
+            xrLayers.reserve(layers.size());
             for(const auto& layer : layers) {
                 std::visit([&](auto xrLayer){
                     xrLayer->space = m_sessionService.m_baseSpace;
@@ -334,14 +629,75 @@ namespace vr {
             endFrameInfo.layerCount = xrLayers.size();
             endFrameInfo.layers = xrLayers.data();
             endFrameInfo.displayTime = m_frameState.predictedDisplayTime;
-            xrEndFrame(session, &endFrameInfo);
+            {
+                util::HeapGuardPause runtime;
+                xrEndFrame(session, &endFrameInfo);
+            }
+
+            if(recorder) {
+                recorder->frame().capture(m_frameState);
+                recorder->submit();
+            }
         }
+        frameArena.reset();
+        profiler.record(FrameProfiler::Frame, Clock::now() - frameStart);
+        profiler.nextFrame();
 
+        // reports format their output on the heap, so they run outside the guarded frame
+        if(auto& sampler = m_sessionService.m_inputSampler; sampler.running()) {
+            sampler.report();
+        }
+        auto& pacingStats = m_sessionService.m_pacingStats;
+        pacingStats.record(frameWaited - frameStart, Clock::now() - frameWaited, m_frameState.predictedDisplayPeriod);
+        pacingStats.report(m_sessionService.m_framePacer.running() ? "pipelined" : "synchronous");
+    }
+
+    void SessionStateRunning::locateViews() {
+        auto& views = m_sessionService.m_views;
+        auto& viewState = m_sessionService.m_viewState;
+        viewState = makeStruct<XrViewState>();
+
+        auto viewLocateInfo = makeStruct<XrViewLocateInfo>();
+        viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        viewLocateInfo.displayTime = m_frameState.predictedDisplayTime;
+        viewLocateInfo.space = m_sessionService.m_baseSpace;
+
+        auto result = xrLocateViews(m_sessionService.m_session, &viewLocateInfo, &viewState
+                                    , views.size(), &m_sessionService.m_viewCount, views.data());
+        LOG_ERROR(m_sessionService.m_ctx.instance, result);
+        if(XR_FAILED(result)) {
+            m_sessionService.m_viewCount = 0;
+        }
+    }
+
+    void SessionStateRunning::locateSpaces() {
+        // only the spaces the renderer asked for and those the active pose actions read are located
+        auto& spaceLocator = m_sessionService.m_spaceLocator;
+        spaceLocator.clearRequired();
+        spaceLocator.require(m_sessionService.m_poseActionSpaces);
+        spaceLocator.require(m_sessionService.m_renderer->spaces());
+        {
+            util::HeapGuardPause runtime;
+            spaceLocator.locate(m_sessionService.m_baseSpace, m_frameState.predictedDisplayTime);
+            m_sessionService.m_handTracker.locate(m_sessionService.m_baseSpace, m_frameState.predictedDisplayTime);
+        }
+
+        auto& poseHistory = m_sessionService.m_poseHistory;
+        for(SpaceId id = 0; id < spaceLocator.size(); ++id) {
+            if(!spaceLocator.isLocated(id)) continue;
+
+            const auto& velocity = spaceLocator.velocity(id);
+            poseHistory.record(id, { m_frameState.predictedDisplayTime, spaceLocator.pose(id)
+                                     , { velocity.linearVelocity.x, velocity.linearVelocity.y, velocity.linearVelocity.z }
+                                     , { velocity.angularVelocity.x, velocity.angularVelocity.y, velocity.angularVelocity.z }
+                                     , spaceLocator.hasVelocity(id) });
+        }
     }
 
     void SessionStateRunning::handle(const XrEventDataSessionStateChanged &event) {
         if(event.state == XR_SESSION_STATE_STOPPING) {
             m_sessionService.transitionTo(XR_SESSION_STATE_STOPPING);
+            m_sessionService.stopFramePacer();
             xrEndSession(m_sessionService.m_session);
         }else {
             SessionState::handle(event);
@@ -350,6 +706,8 @@ namespace vr {
 
     void SessionStateRunning::endFrame() {
         m_sessionService.m_renderer->endFrame();
+        util::HeapGuardPause driver;
+        m_sessionService.m_graphics->endFrame();
     }
 
     void SessionIdle::handle(const XrEventDataSessionStateChanged &event) {
@@ -365,8 +723,13 @@ namespace vr {
             auto result =  xrBeginSession(m_sessionService.m_session, &beginInfo);
             LOG_ERROR(m_sessionService.m_ctx.instance, result)
             spdlog::debug("XR session begun");
+
+            if(XR_SUCCEEDED(result) && m_sessionService.m_config._pipelined) {
+                m_sessionService.m_framePacer.start(m_sessionService.m_session);
+            }
         }else if(state == XR_SESSION_STATE_EXITING || state == XR_SESSION_STATE_LOSS_PENDING) {
             m_sessionService.transitionTo(state);
+            m_sessionService.m_handTracker.destroy();
             CHECK_XR(xrDestroySession(m_sessionService.m_session));
         }else {
             SessionState::handle(event);
@@ -374,11 +737,6 @@ namespace vr {
     }
 
 
-    void SessionIdle::processFrame() {
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(10ms);
-    }
-
 
     void SessionVisible::frameLoop(const FrameInfo &frameInfo, Layers& layers) {
         return m_sessionService.m_renderer->paused(frameInfo, layers);
@@ -388,36 +746,42 @@ namespace vr {
         return m_sessionService.m_renderer->render(frameInfo, layers);
     }
 
-    void SessionFocused::processFrame() {
-        auto syncInfo = makeStruct<XrActionsSyncInfo>();
-        syncInfo.countActiveActionSets = m_sessionService.m_activeActionSets.size();
-        syncInfo.activeActionSets = m_sessionService.m_activeActionSets.data();
-        CHECK_XR(xrSyncActions(m_sessionService.m_session, &syncInfo));
-
+    void SessionFocused::syncActions() {
         const auto& activeSets = m_sessionService.m_activeActionSets;
-        const auto& session = m_sessionService.m_session;
-        const auto& actionSpaces = m_sessionService.m_actionSpaces;
-        const auto& baseSpace = m_sessionService.m_baseSpace;
+        if(!activeSets.empty()) {
+            auto syncInfo = makeStruct<XrActionsSyncInfo>();
+            syncInfo.countActiveActionSets = activeSets.size();
+            syncInfo.activeActionSets = activeSets.data();
+            CHECK_XR(xrSyncActions(m_sessionService.m_session, &syncInfo));
+        }
+    }
 
-        m_sessionService.m_renderer->beginFrame();
+    void SessionFocused::processInput() {
+        const auto& session = m_sessionService.m_session;
+        const auto& spaceLocator = m_sessionService.m_spaceLocator;
+        const auto& poseThreshold = m_sessionService.m_poseThreshold;
 
+        // polling is all runtime calls, the guard resumes for the renderer's callbacks
+        std::optional<util::HeapGuardPause> polling{ std::in_place };
         for(auto& binding : m_sessionService.m_actionSetBindings) {
-            bool inActive = std::any_of(activeSets.begin(), activeSets.end(), [&binding](const auto& aSet){ return aSet.actionSet != binding.xrActionSet; });
-            if(inActive) continue;
+            if(!binding.active) continue;
 
-            for(const auto& [name, action] : binding.actions) {
-                assert(binding.actionSet.actions.contains(name));
+            auto& actionSet = binding.actionSet;
+            for(ActionId id = 0; id < binding.actions.size(); ++id) {
+                auto& action = binding.actions[id];
+                auto& actionState = actionSet[id];
+                actionState.changed = false;
 
                 auto getInfo = makeStruct<XrActionStateGetInfo>();
                 getInfo.action = action._;
-                switch(getActionType(action.input.component)) {
+                switch(action.type) {
                     case XR_ACTION_TYPE_BOOLEAN_INPUT : {
                         auto state = makeStruct<XrActionStateBoolean>();
                         CHECK_XR(xrGetActionStateBoolean(session, &getInfo, &state));
                         if(state.isActive) {
-                            binding.actionSet.actions[name].isActive = true;
-                            binding.actionSet.actions[name].changed = state.changedSinceLastSync;
-                            binding.actionSet.actions[name]._value = static_cast<bool>(state.currentState);
+                            actionState.isActive = true;
+                            actionState.changed = state.changedSinceLastSync;
+                            actionState._value = static_cast<bool>(state.currentState);
                         }
                         break;
                     }
@@ -425,9 +789,9 @@ namespace vr {
                         auto state = makeStruct<XrActionStateFloat>();
                         CHECK_XR(xrGetActionStateFloat(session, &getInfo, &state));
                         if(state.isActive) {
-                            binding.actionSet.actions[name].isActive = true;
-                            binding.actionSet.actions[name].changed = state.changedSinceLastSync;
-                            binding.actionSet.actions[name]._value = state.currentState;
+                            actionState.isActive = true;
+                            actionState.changed = state.changedSinceLastSync;
+                            actionState._value = state.currentState;
                         }
                         break;
                     }
@@ -435,9 +799,9 @@ namespace vr {
                         auto state = makeStruct<XrActionStateVector2f>();
                         CHECK_XR(xrGetActionStateVector2f(session, &getInfo, &state));
                         if(state.isActive) {
-                            binding.actionSet.actions[name].isActive = true;
-                            binding.actionSet.actions[name].changed = state.changedSinceLastSync;
-                            binding.actionSet.actions[name]._value = glm::vec2(state.currentState.x, state.currentState.y);
+                            actionState.isActive = true;
+                            actionState.changed = state.changedSinceLastSync;
+                            actionState._value = glm::vec2(state.currentState.x, state.currentState.y);
                         }
                         break;
                     }
@@ -445,12 +809,13 @@ namespace vr {
                         auto state = makeStruct<XrActionStatePose>();
                         CHECK_XR(xrGetActionStatePose(session, &getInfo, &state));
                         if(state.isActive) {
-                            binding.actionSet.actions[name].isActive = true;
-
-                            auto space = actionSpaces.at(name);
-                            auto location = makeStruct<XrSpaceLocation>();
-                            xrLocateSpace(space, baseSpace, m_frameState.predictedDisplayTime, &location);
-                            binding.actionSet.actions[name]._value = convert(location.pose);
+                            actionState.isActive = true;
+                            const auto pose = spaceLocator.pose(action.space);
+                            if(poseThreshold.exceeded(action.reportedPose, pose)) {
+                                action.reportedPose = pose;
+                                actionState.changed = true;
+                            }
+                            actionState._value = pose;
                         }
                         break;
                     }
@@ -460,20 +825,48 @@ namespace vr {
 
                 }
             }
-            auto vibrations = m_sessionService.m_renderer->set(binding.actionSet);
+        }
+
+        polling.reset();
+
+        auto& actionSets = m_sessionService.m_actionSets;
+        if(auto replayed = m_sessionService.replayFrame()) {
+            replayed->apply(actionSets);
+        }
+        if(auto& recorder = m_sessionService.m_recorder) {
+            recorder->frame().capture(actionSets);
+        }
+
+        auto& renderer = *m_sessionService.m_renderer;
+        for(auto& binding : m_sessionService.m_actionSetBindings) {
+            if(!binding.active) continue;
+
+            // reserved for every action of the set when the actions were set up
+            auto& changed = binding.changed;
+            changed.clear();
+            for(ActionId id = 0; id < binding.actionSet.size(); ++id) {
+                if(binding.actionSet[id].changed) {
+                    changed.push_back(id);
+                }
+            }
+            if(!changed.empty()) {
+                renderer.changed(binding.actionSet, changed);
+            }
+
+            auto vibrations = renderer.set(binding.actionSet);
             for(const auto& vibration : vibrations) {
-                auto action = m_sessionService.m_actionSetBindings.front().actions.at(vibration.action);
+                assert(vibration.action < binding.actions.size());
+                const auto& action = binding.actions[vibration.action];
                 auto info = makeStruct<XrHapticActionInfo>();
                 info.action = action._;
                 auto hapticVibration = makeStruct<XrHapticVibration>();
                 hapticVibration.duration = vibration.duration;
                 hapticVibration.frequency = vibration.frequency;
                 hapticVibration.amplitude = vibration.amplitude;
+                util::HeapGuardPause runtime;
                 xrApplyHapticFeedback(m_sessionService.m_session, &info, reinterpret_cast<XrHapticBaseHeader*>(&hapticVibration));
             }
         }
-
-        SessionStateRunning::processFrame();
     }
 
 }
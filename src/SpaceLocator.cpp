@@ -0,0 +1,126 @@
+#include "check.hpp"
+#include "vr/SpaceLocator.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+
+namespace vr {
+
+    void SpaceLocator::init(const Context &context, XrSession session) {
+        m_session = session;
+        m_locateSpaces = nullptr;
+
+#ifdef XR_KHR_locate_spaces
+        cstring procName = nullptr;
+#ifdef XR_VERSION_1_1
+        if(context.info.applicationInfo.apiVersion >= XR_MAKE_VERSION(1, 1, 0)) {
+            procName = "xrLocateSpaces";
+        }
+#endif
+        if(!procName && context.isEnabled(XR_KHR_LOCATE_SPACES_EXTENSION_NAME)) {
+            procName = "xrLocateSpacesKHR";
+        }
+        if(procName && XR_FAILED(xrGetInstanceProcAddr(context.instance, procName, &m_locateSpaces))) {
+            m_locateSpaces = nullptr;
+        }
+#endif
+        spdlog::info("spaces will be located {}", batched() ? "in batches" : "individually");
+    }
+
+    SpaceId SpaceLocator::add(XrSpace space, std::string name) {
+        const auto id = static_cast<SpaceId>(m_spaces.size());
+        m_spaces.push_back(space);
+        m_names.push_back(std::move(name));
+        m_locations.push_back({ 0, {{0, 0, 0, 1}, {0, 0, 0}} });
+        m_velocities.push_back({ 0, {0, 0, 0}, {0, 0, 0} });
+        m_isRequired.push_back(0);
+
+        // requiring and locating spaces happens on the frame thread and must not allocate
+        m_required.reserve(m_spaces.size());
+        m_batchSpaces.reserve(m_spaces.size());
+        m_batchLocations.resize(m_spaces.size());
+        m_batchVelocities.resize(m_spaces.size());
+        return id;
+    }
+
+    std::optional<SpaceId> SpaceLocator::find(std::string_view name) const {
+        for(SpaceId id = 0; id < m_names.size(); ++id) {
+            if(m_names[id] == name) return id;
+        }
+        return {};
+    }
+
+    void SpaceLocator::require(SpaceId id) {
+        if(id >= m_spaces.size() || m_isRequired[id]) return;
+        m_isRequired[id] = 1;
+        m_required.push_back(id);
+    }
+
+    void SpaceLocator::clearRequired() {
+        for(auto id : m_required) {
+            m_isRequired[id] = 0;
+        }
+        m_required.clear();
+    }
+
+    void SpaceLocator::set(SpaceId id, const Pose &pose, bool located) {
+        m_locations[id].locationFlags = located ? XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT : 0;
+        m_locations[id].pose = convert(pose);
+        m_velocities[id].velocityFlags = 0;
+    }
+
+    void SpaceLocator::locate(XrSpace baseSpace, XrTime time) {
+        for(auto& location : m_locations) location.locationFlags = 0;
+        for(auto& velocity : m_velocities) velocity.velocityFlags = 0;
+        if(m_required.empty()) return;
+
+#ifdef XR_KHR_locate_spaces
+        if(m_locateSpaces) {
+            // with every space required the results go straight to their slots, otherwise they are gathered and scattered
+            const auto all = m_required.size() == m_spaces.size();
+            if(!all) {
+                m_batchSpaces.clear();
+                for(auto id : m_required) {
+                    m_batchSpaces.push_back(m_spaces[id]);
+                }
+            }
+            const auto count = static_cast<uint32_t>(m_required.size());
+
+            auto locateInfo = makeStruct<XrSpacesLocateInfoKHR>();
+            locateInfo.baseSpace = baseSpace;
+            locateInfo.time = time;
+            locateInfo.spaceCount = count;
+            locateInfo.spaces = all ? m_spaces.data() : m_batchSpaces.data();
+
+            auto velocities = makeStruct<XrSpaceVelocitiesKHR>();
+            velocities.velocityCount = count;
+            velocities.velocities = all ? m_velocities.data() : m_batchVelocities.data();
+
+            auto locations = makeStruct<XrSpaceLocationsKHR>();
+            locations.next = &velocities;
+            locations.locationCount = count;
+            locations.locations = all ? m_locations.data() : m_batchLocations.data();
+
+            auto locateSpaces = reinterpret_cast<PFN_xrLocateSpacesKHR>(m_locateSpaces);
+            if(XR_SUCCEEDED(locateSpaces(m_session, &locateInfo, &locations))) {
+                if(!all) {
+                    for(auto i = 0u; i < count; ++i) {
+                        m_locations[m_required[i]] = m_batchLocations[i];
+                        m_velocities[m_required[i]] = m_batchVelocities[i];
+                    }
+                }
+                return;
+            }
+        }
+#endif
+        for(auto id : m_required) {
+            auto velocity = makeStruct<XrSpaceVelocity>();
+            auto location = makeStruct<XrSpaceLocation>();
+            location.next = &velocity;
+            xrLocateSpace(m_spaces[id], baseSpace, time, &location);
+            m_locations[id].locationFlags = location.locationFlags;
+            m_locations[id].pose = location.pose;
+            m_velocities[id] = { velocity.velocityFlags, velocity.linearVelocity, velocity.angularVelocity };
+        }
+    }
+}
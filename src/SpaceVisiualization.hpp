@@ -7,12 +7,23 @@
 #include "geom/Geometry.hpp"
 #include "xform/xforms.hpp"
 #include "vr/Models.hpp"
+#include "vr/ActionTable.hpp"
+#include "vr/LateLatch.hpp"
 
 #include <algorithm>
 #include <array>
 
 enum Hand : uint32_t { LEFT = 0, RIGHT };
 
+inline constexpr vr::ActionTable SpaceVisualizationActions{ "main_action_set", "main action set", {
+    {"left_hand_pose", vr::Source::LEFT_HAND, vr::Identifier::GRIP, vr::Component::POSE, "left hand grip"},
+    {"right_hand_pose", vr::Source::RIGHT_HAND, vr::Identifier::GRIP, vr::Component::POSE, "right hand grip"},
+    {"left_hand_squeeze", vr::Source::LEFT_HAND, vr::Identifier::SQUEEZE, vr::Component::VALUE, "left hand squeeze"},
+    {"right_hand_squeeze", vr::Source::RIGHT_HAND, vr::Identifier::SQUEEZE, vr::Component::VALUE, "right hand squeeze"},
+    {"vibrate_left", vr::Source::LEFT_HAND, vr::Identifier::HAPTIC, vr::Component::VIBRATE, "vibrate left hand"},
+    {"vibrate_right", vr::Source::RIGHT_HAND, vr::Identifier::HAPTIC, vr::Component::VIBRATE, "vibrate right hand"},
+}};
+
 struct FrameBufferAttachment {
     vr::Image image;
     VkImageView imageView{};
@@ -32,14 +43,26 @@ struct CameraType {
     glm::mat4 projection;
 };
 
-struct Mvp{
-    glm::mat4 model{1};
-    glm::mat4 view{1};
-    glm::mat4 projection{1};
-};
-
 struct Cube {
+    static constexpr vr::SpaceId Unlatched{ ~0u };
+
     vr::Transform transform;
+    vr::SpaceId space{Unlatched};   // drawn at the space's latched pose when there is one
+};
+
+// per instance attributes of the cube pipeline
+struct CubeInstance {
+    glm::mat4 model;
+    glm::vec3 scale;
+    vr::SpaceId space;
+};
+
+// joints of both hands as the joints shader reads them, left hand first
+struct HandJointInstances {
+    static constexpr uint32_t Count{ vr::HandJoints::Count * 2 };
+
+    std::array<glm::vec4, Count> positions;
+    std::array<glm::quat, Count> orientations;
 };
 
 struct SpaceVisualization : public vr::VulkanRenderer {
@@ -47,6 +70,7 @@ public:
     ~SpaceVisualization() override = default;
 
     void init() override {
+        m_cubes.reserve(MaxCubes);
         createCubes();
         createFrameBufferAttachments();
         createRenderPass();
@@ -55,28 +79,24 @@ public:
         createDescriptorSetLayout();
         updateDescriptorSet();
         createPipeline();
-        createCommandBuffer();
         setupViews();
     }
 
     void createCubes() {
         using namespace units;
         auto cube = geom::cube();
-        auto staging = graphicsService().createStagingBuffer(1_mb);
+        auto& uploads = graphicsService().uploads();
 
         debugBuffer = graphicsService().createMappableBuffer(1_kb, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 
         auto size = BYTE_SIZE(cube.vertices);
-        auto mapping = graphicsService().map(staging);
-        std::memcpy(mapping._, cube.vertices.data(), size);
         m_cube.vertex = graphicsService().createDeviceLocalBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-        graphicsService().copy(staging, m_cube.vertex, size);
+        uploads.copy(uploads.stage(cube.vertices.data(), size), m_cube.vertex._);
 
         size = BYTE_SIZE(cube.indices);
         m_cube.index = graphicsService().createDeviceLocalBuffer(size, VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT);
-        std::memcpy(mapping._, cube.indices.data(), size);
-        graphicsService().copy(staging, m_cube.index, size);
-        graphicsService().release(staging);
+        uploads.copy(uploads.stage(cube.indices.data(), size), m_cube.index._);
+        uploads.submit();
     }
 
     void createRenderPass() {
@@ -115,10 +135,11 @@ public:
 
         dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
         dependency.dstSubpass = 0;
-        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-        dependency.srcAccessMask = 0;
-        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        // the depth buffers are shared by frames in flight, so the previous frame's depth writes must complete first
+        dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependency.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
         auto createInfo = makeStruct<VkRenderPassCreateInfo>();
         createInfo.attachmentCount = attachments.size();
@@ -206,9 +227,10 @@ public:
     }
 
     void createDescriptorPool() {
-        std::array<VkDescriptorPoolSize, 2> poolSizes{{
-            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1U},
-            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U}
+        std::array<VkDescriptorPoolSize, 3> poolSizes{{
+            {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1U},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1U},
+            {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, 2U}
         }};
         auto createInfo = makeStruct<VkDescriptorPoolCreateInfo>();
         createInfo.maxSets = 1;
@@ -219,11 +241,26 @@ public:
     }
 
     void createDescriptorSetLayout() {
-        std::array<VkDescriptorSetLayoutBinding, 1> bindings{};
+        std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
         bindings[0].binding = 0;
         bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
         bindings[0].descriptorCount = 1;
         bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+        bindings[1].binding = 1;
+        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        bindings[1].descriptorCount = 1;
+        bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+        bindings[2].binding = 2;
+        bindings[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        bindings[2].descriptorCount = 1;
+        bindings[2].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+        bindings[3].binding = 3;
+        bindings[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        bindings[3].descriptorCount = 1;
+        bindings[3].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
         
 //        bindings[1].binding = 1;
 //        bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
@@ -242,7 +279,10 @@ public:
 
     void updateDescriptorSet() {
         m_descriptorSet = graphicsService().allocate(m_pool, m_descriptorSetLayout).front();
-        std::array<VkWriteDescriptorSet, 1 > writes {
+        std::array<VkWriteDescriptorSet, 4 > writes {
+                makeStruct<VkWriteDescriptorSet>(),
+                makeStruct<VkWriteDescriptorSet>(),
+                makeStruct<VkWriteDescriptorSet>(),
                 makeStruct<VkWriteDescriptorSet>()
         };
         
@@ -260,6 +300,29 @@ public:
         VkDescriptorBufferInfo xformInfo{ debugBuffer._, 0, VK_WHOLE_SIZE};
         writes[0].pBufferInfo = &xformInfo;
 
+        writes[1].dstSet = m_descriptorSet;
+        writes[1].dstBinding = 1;
+        writes[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        writes[1].descriptorCount = 1;
+        // per frame data lives in the frame ring, where it is picked by dynamic offsets when binding
+        const auto frameRing = graphicsService().frameRing().buffer();
+        VkDescriptorBufferInfo jointsInfo{ frameRing, 0, sizeof(HandJointInstances)};
+        writes[1].pBufferInfo = &jointsInfo;
+
+        writes[2].dstSet = m_descriptorSet;
+        writes[2].dstBinding = 2;
+        writes[2].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        writes[2].descriptorCount = 1;
+        VkDescriptorBufferInfo cameraInfo{ frameRing, 0, sizeof(CameraType)};
+        writes[2].pBufferInfo = &cameraInfo;
+
+        writes[3].dstSet = m_descriptorSet;
+        writes[3].dstBinding = 3;
+        writes[3].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+        writes[3].descriptorCount = 1;
+        VkDescriptorBufferInfo latchedInfo{ frameRing, 0, sizeof(vr::LatchedPoses)};
+        writes[3].pBufferInfo = &latchedInfo;
+
         graphicsService().update(writes);
 
     }
@@ -285,19 +348,28 @@ public:
 
         std::array<VkPipelineShaderStageCreateInfo, 2> stages{ vertexShaderStage, fragmentShaderModule };
 
-        // Vertex Input State
-        VkVertexInputBindingDescription vertexBinding{ 0, sizeof(geom::Vertex), VK_VERTEX_INPUT_RATE_VERTEX };
-        std::array<VkVertexInputAttributeDescription, 6> attributeDescriptions {{
+        // Vertex Input State, cube models are per instance attributes
+        std::array<VkVertexInputBindingDescription, 2> vertexBindings{{
+                { 0, sizeof(geom::Vertex), VK_VERTEX_INPUT_RATE_VERTEX },
+                { 1, sizeof(CubeInstance), VK_VERTEX_INPUT_RATE_INSTANCE }
+        }};
+        std::array<VkVertexInputAttributeDescription, 12> attributeDescriptions {{
                 {0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetOf(geom::Vertex, position)},
                 {1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetOf(geom::Vertex, normal)},
                 {2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetOf(geom::Vertex, tangent)},
                 {3, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetOf(geom::Vertex, bitangent)},
                 {4, 0, VK_FORMAT_R32G32_SFLOAT, offsetOf(geom::Vertex, uv)},
                 {5, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetOf(geom::Vertex, color)},
+                {6, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 0},
+                {7, 1, VK_FORMAT_R32G32B32A32_SFLOAT, sizeof(glm::vec4)},
+                {8, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 2 * sizeof(glm::vec4)},
+                {9, 1, VK_FORMAT_R32G32B32A32_SFLOAT, 3 * sizeof(glm::vec4)},
+                {10, 1, VK_FORMAT_R32G32B32_SFLOAT, offsetOf(CubeInstance, scale)},
+                {11, 1, VK_FORMAT_R32_UINT, offsetOf(CubeInstance, space)},
         }};
         auto vertexInputState = makeStruct<VkPipelineVertexInputStateCreateInfo>();
-        vertexInputState.vertexBindingDescriptionCount = 1;
-        vertexInputState.pVertexBindingDescriptions = &vertexBinding;
+        vertexInputState.vertexBindingDescriptionCount = vertexBindings.size();
+        vertexInputState.pVertexBindingDescriptions = vertexBindings.data();
         vertexInputState.vertexAttributeDescriptionCount = attributeDescriptions.size();
         vertexInputState.pVertexAttributeDescriptions = attributeDescriptions.data();
 
@@ -354,9 +426,6 @@ public:
         auto pipelineLayoutCreateInfo = makeStruct<VkPipelineLayoutCreateInfo>();
         pipelineLayoutCreateInfo.setLayoutCount = 1;
         pipelineLayoutCreateInfo.pSetLayouts = &m_descriptorSetLayout;
-        VkPushConstantRange constants{VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(Mvp)};
-        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
-        pipelineLayoutCreateInfo.pPushConstantRanges = &constants;
 
 
         // pipeline layout
@@ -381,11 +450,18 @@ public:
 
         m_pipeline._ = graphicsService().createGraphicsPipeline(createInfo);
 
-    }
+        // hand joints draw the same cube instanced, positioned by the joints buffer instead of model matrices
+        auto jModule = graphicsService().createShaderModule(R"(..\..\..\src\resources\shaders\joints.vert.spv)");
+        stages[0].module = jModule;
+        vertexInputState.vertexBindingDescriptionCount = 1;
+        vertexInputState.vertexAttributeDescriptionCount = 2;
+        m_pipeline.joints = graphicsService().createGraphicsPipeline(createInfo);
+
+        // shader modules are only needed to create the pipelines
+        graphicsService().release(vModule);
+        graphicsService().release(fModule);
+        graphicsService().release(jModule);
 
-    void createCommandBuffer() {
-        auto cmdBuffers = graphicsService().allocateCommandBuffers(2);
-        m_commandBuffers = std::vector<VkCommandBuffer>(cmdBuffers.begin(), cmdBuffers.end());
     }
 
     void setupViews() {
@@ -406,44 +482,107 @@ public:
 
     void beginFrame() override {
         m_cubes.clear();
+        m_handTracked.fill(false);
+        m_jointsData = {};
+
+        // nothing is latched until the session writes the poses right before submission
+        m_latched = graphicsService().frameRing().allocate(sizeof(vr::LatchedPoses));
+        m_latched.as<vr::LatchedPoses>()->viewCount = 0;
+        m_latched.as<vr::LatchedPoses>()->spaceCount = 0;
+    }
+
+    // only spaces are latched, the views drawn are the ones the projection layer is submitted with
+    vr::LatchedPoses* lateLatchTarget() final {
+        return m_latched.as<vr::LatchedPoses>();
     }
 
-    void set(const std::vector<vr::SpaceLocation> &spaceLocations) final {
+    void bind(const vr::SpaceLocator& spaces) final {
+        // a cube for every named (reference) space, action spaces are drawn from their actions
+        m_spaces.clear();
+        for(vr::SpaceId id = 0; id < spaces.size(); ++id) {
+            if(!spaces.name(id).empty()) {
+                m_spaces.push_back(id);
+            }
+        }
+        // room for every space plus the two hand cubes, so the per-frame pushes never reallocate
+        m_cubes.reserve(std::max(MaxCubes, m_spaces.size() + 2));
+    }
+
+    std::span<const vr::SpaceId> spaces() final {
+        return m_spaces;
+    }
+
+    void set(const vr::SpaceLocator& spaces) final {
         Cube cube{};
-        for(const auto & spaceLocation : spaceLocations) {
-            cube.transform.pose = spaceLocation.pose;
+        for(const auto id : m_spaces) {
+            if(!spaces.isLocated(id)) continue;
+
+            cube.transform.pose = spaces.pose(id);
             cube.transform.scale = glm::vec3(0.25);
+            cube.space = id;
             m_cubes.push_back(cube);
         }
     }
 
-    std::vector<vr::Vibrate> set(const vr::ActionSet &actionSet) final {
-        std::vector<vr::Vibrate> vibrations{};
-        if(actionSet.get("left_hand_squeeze").isActive) {
-            auto value = actionSet.get("left_hand_squeeze").value<float>();
+    void set(const vr::HandTracker& hands) final {
+        m_jointsData = graphicsService().frameRing().allocate(sizeof(HandJointInstances));
+        auto& instances = *m_jointsData.as<HandJointInstances>();
+        for(auto i = 0u; i < m_handTracked.size(); ++i) {
+            const auto& joints = hands[static_cast<vr::Handedness>(i)];
+            m_handTracked[i] = joints.isActive;
+            if(!joints.isActive) continue;
+
+            const auto first = i * vr::HandJoints::Count;
+            std::copy(joints.positions.begin(), joints.positions.end(), instances.positions.begin() + first);
+            std::copy(joints.orientations.begin(), joints.orientations.end(), instances.orientations.begin() + first);
+            for(auto joint = 0u; joint < vr::HandJoints::Count; ++joint) {
+                if(!joints.isLocated(joint)) {
+                    instances.positions[first + joint].w = 0;   // collapses the joint's cube
+                }
+            }
+        }
+    }
+
+    void bind(const vr::ActionSet &actionSet) final {
+        if(actionSet.name == SpaceVisualizationActions.name) {
+            SpaceVisualizationActions.verify(actionSet);
+            m_actionSet = actionSet.id;
+        }
+    }
+
+    vr::Vibrations set(const vr::ActionSet &actionSet) final {
+        vr::Vibrations vibrations{ frameMemory() };
+        if(actionSet.id != m_actionSet) {
+            return vibrations;
+        }
+
+        if(actionSet[LeftHandSqueeze].isActive) {
+            auto value = actionSet.value(LeftHandSqueeze);
             handScale[Hand::LEFT] = 1.0f - 0.5f * value;
 
             if(value > 0.9) {
-                vibrations.push_back({"vibrate_left"});
+                vibrations.push_back({VibrateLeft.id});
             }
         }
-        if(actionSet.get("right_hand_squeeze").isActive) {
-            auto value = actionSet.get("right_hand_squeeze").value<float>();
+        if(actionSet[RightHandSqueeze].isActive) {
+            auto value = actionSet.value(RightHandSqueeze);
             handScale[Hand::RIGHT] = 1.0f - 0.5f * value;
             if(value > 0.9) {
-                vibrations.push_back({"vibrate_right"});
+                vibrations.push_back({VibrateRight.id});
             }
         }
 
         Cube cube{};
-        if(actionSet.get("left_hand_pose").isActive) {
-            cube.transform.pose = actionSet.get("left_hand_pose").value<vr::Pose>();
+        if(actionSet[LeftHandPose].isActive) {
+            cube.transform.pose = actionSet.value(LeftHandPose);
             cube.transform.scale = glm::vec3(0.1) * handScale[Hand::LEFT];
+            cube.space = poseHistory().space(m_actionSet, LeftHandPose).value_or(Cube::Unlatched);
             m_cubes.push_back(cube);
         }
-        if(actionSet.get("right_hand_pose").isActive) {
-            cube.transform.pose = actionSet.get("right_hand_pose").value<vr::Pose>();
+        if(actionSet[RightHandPose].isActive) {
+            cube.transform.pose = actionSet.value(RightHandPose);
             cube.transform.scale = glm::vec3(0.1) * handScale[Hand::RIGHT];
+            cube.space = poseHistory().space(m_actionSet, RightHandPose).value_or(Cube::Unlatched);
             m_cubes.push_back(cube);
         }
 
@@ -468,15 +607,31 @@ public:
 
     void renderCubes(const vr::FrameInfo &frameInfo) {
         const auto& views = frameInfo.viewInfo.views;
+        auto commandBuffers = graphicsService().frameCommandBuffers(views.size());
+        auto& frameRing = graphicsService().frameRing();
+
+        // the joints binding needs a valid offset even when no hand is drawn
+        if(!m_jointsData.buffer) {
+            m_jointsData = frameRing.allocate(sizeof(HandJointInstances));
+        }
+
+        const auto models = frameRing.allocate(sizeof(CubeInstance) * std::max<size_t>(m_cubes.size(), 1));
+        for(auto i = 0u; i < m_cubes.size(); ++i) {
+            const auto& cube = m_cubes[i];
+            models.as<CubeInstance>()[i] = { static_cast<glm::mat4>(cube.transform), cube.transform.scale, cube.space };
+        }
 
         for (auto vi = 0; vi < views.size(); ++vi) {
             auto& view = views[vi];
             const auto &swapChain = graphicsService().getSwapChain("main");
-            mvp.view = glm::inverse(vr::toMatrix(view.pose));
-            mvp.projection = graphicsService().projection(view.fov, 0.05, 100);
+            const auto camera = frameRing.push(CameraType{
+                glm::inverse(vr::toMatrix(view.pose)),
+                graphicsService().projection(view.fov, 0.05, 100)
+            });
 
-            auto commandBuffer = m_commandBuffers[vi];
+            auto commandBuffer = commandBuffers[vi];
             auto beginInfo = makeStruct<VkCommandBufferBeginInfo>();
+            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
             vkBeginCommandBuffer(commandBuffer, &beginInfo);
             std::array<VkClearValue, 2> clearValues{};
             clearValues[0].color = {0.184313729f, 0.309803933f, 0.309803933f, 1.f};
@@ -492,26 +647,35 @@ public:
             vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
 
             vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline._);
+            // dynamic offsets in binding order, joints, camera then latched poses
+            const std::array<uint32_t, 3> dynamicOffsets{ m_jointsData.offset, camera.offset, m_latched.offset };
             vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline.layout, 0, 1,
-                                    &m_descriptorSet, 0, VK_NULL_HANDLE);
+                                    &m_descriptorSet, dynamicOffsets.size(), dynamicOffsets.data());
 
-            VkDeviceSize offset = 0;
-            vkCmdBindVertexBuffers(commandBuffer, 0, 1, &m_cube.vertex._, &offset);
+            const std::array<VkBuffer, 2> vertexBuffers{ m_cube.vertex._, models.buffer };
+            const std::array<VkDeviceSize, 2> vertexOffsets{ 0, models.offset };
+            vkCmdBindVertexBuffers(commandBuffer, 0, vertexBuffers.size(), vertexBuffers.data(), vertexOffsets.data());
             vkCmdBindIndexBuffer(commandBuffer, m_cube.index._, 0, VK_INDEX_TYPE_UINT32);
             uint32_t indexCount = m_cube.index.info.size / sizeof(uint32_t);
 
-            for (const auto& cube : m_cubes) {
-                mvp.model = static_cast<glm::mat4>(cube.transform);
-                vkCmdPushConstants(commandBuffer, m_pipeline.layout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(mvp),
-                                   &mvp.model);
-                vkCmdDrawIndexed(commandBuffer, indexCount, 1, 0, 0, 0);
+            if(!m_cubes.empty()) {
+                vkCmdDrawIndexed(commandBuffer, indexCount, m_cubes.size(), 0, 0, 0);
+            }
+
+            if(std::ranges::any_of(m_handTracked, [](auto tracked){ return tracked; })) {
+                vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline.joints);
+                for(auto hand = 0u; hand < m_handTracked.size(); ++hand) {
+                    if(m_handTracked[hand]) {
+                        vkCmdDrawIndexed(commandBuffer, indexCount, vr::HandJoints::Count, 0, 0, hand * vr::HandJoints::Count);
+                    }
+                }
             }
             vkCmdEndRenderPass(commandBuffer);
             vkEndCommandBuffer(commandBuffer);
         }
         auto submitInfo = makeStruct<VkSubmitInfo>();
-        submitInfo.commandBufferCount = m_commandBuffers.size();
-        submitInfo.pCommandBuffers = m_commandBuffers.data();
+        submitInfo.commandBufferCount = commandBuffers.size();
+        submitInfo.pCommandBuffers = commandBuffers.data();
         graphicsService().submitToGraphicsQueue(submitInfo);
 
     }
@@ -561,17 +725,8 @@ public:
                         .translate(2, 0.5, -2)
                         .rotateInverseY(60)
             )
-            .addActionSet(
-                vr::ActionSetSpecification()
-                    .name("main_action_set")
-                    .description("main action set")
-                    .addAction("left_hand_pose", vr::Source::LEFT_HAND, vr::Identifier::GRIP, vr::Component::POSE, "left hand grip")
-                    .addAction("right_hand_pose", vr::Source::RIGHT_HAND, vr::Identifier::GRIP, vr::Component::POSE, "right hand grip")
-                    .addAction("left_hand_squeeze", vr::Source::LEFT_HAND, vr::Identifier::SQUEEZE, vr::Component::VALUE, "left hand squeeze")
-                    .addAction("right_hand_squeeze", vr::Source::RIGHT_HAND, vr::Identifier::SQUEEZE, vr::Component::VALUE, "right hand squeeze")
-                    .addAction("vibrate_left", vr::Source::LEFT_HAND, vr::Identifier::HAPTIC, vr::Component::VIBRATE, "vibrate left hand")
-                    .addAction("vibrate_right", vr::Source::RIGHT_HAND, vr::Identifier::HAPTIC, vr::Component::VIBRATE, "vibrate right hand")
-             )
+            .addActionSet(SpaceVisualizationActions.specification())
+            .handTracking()
             .addSwapChain(
                 vr::SwapchainSpecification()
                 .name("main")
@@ -602,6 +757,7 @@ private:
     struct {
         VkPipelineLayout layout;
         VkPipeline _;
+        VkPipeline joints;
     } m_pipeline{};
 
     VkDescriptorPool m_pool{};
@@ -611,13 +767,25 @@ private:
     std::array<std::vector<FrameBuffer>, 2> m_frameBuffers;
     std::array<DepthBuffer, 2> m_depthBuffers;
     static constexpr VkFormat depthFormat{ VK_FORMAT_D32_SFLOAT_S8_UINT };
-    std::vector<VkCommandBuffer> m_commandBuffers;
+    static constexpr size_t MaxCubes{ 32 };
     mutable XrCompositionLayerProjection m_projectionLayer{ XR_TYPE_COMPOSITION_LAYER_PROJECTION };
     std::array<XrCompositionLayerProjectionView, 2> m_views {{
          {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW},
          {XR_TYPE_COMPOSITION_LAYER_PROJECTION_VIEW}
      }};
     std::vector<Cube> m_cubes;
-    Mvp mvp{};
+    std::vector<vr::SpaceId> m_spaces;
+    vr::FrameAllocation m_jointsData{};
+    vr::FrameAllocation m_latched{};
+    std::array<bool, 2> m_handTracked{};
     std::array<float, 2> handScale{1, 1};
+
+    vr::ActionSetId m_actionSet{vr::InvalidActionSetId};   // until the set declared by SpaceVisualizationActions is bound
+
+    static constexpr auto LeftHandPose = vr::action<SpaceVisualizationActions, "left_hand_pose">;
+    static constexpr auto RightHandPose = vr::action<SpaceVisualizationActions, "right_hand_pose">;
+    static constexpr auto LeftHandSqueeze = vr::action<SpaceVisualizationActions, "left_hand_squeeze">;
+    static constexpr auto RightHandSqueeze = vr::action<SpaceVisualizationActions, "right_hand_squeeze">;
+    static constexpr auto VibrateLeft = vr::action<SpaceVisualizationActions, "vibrate_left">;
+    static constexpr auto VibrateRight = vr::action<SpaceVisualizationActions, "vibrate_right">;
 };
\ No newline at end of file
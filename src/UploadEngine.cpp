@@ -0,0 +1,399 @@
+#include "check.hpp"
+#include "vr/graphics/vulkan/UploadEngine.hpp"
+#include "xr_struct_mapping.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <cstring>
+#include <array>
+#include <format>
+
+namespace vr {
+
+    namespace {
+        constexpr uint64_t alignUp(uint64_t value, uint64_t alignment) {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+    }
+
+    void UploadStats::log(const char *label) const {
+        using namespace std::chrono;
+        const auto seconds = duration<double>(lastCompletion - firstSubmit).count();
+        const auto megabytes = static_cast<double>(bytes) / (1024.0 * 1024.0);
+        spdlog::info("uploads[{}]: {:.2f} MB in {} regions over {} batches, {:.1f} MB/s, {} dedicated staging buffers, {} ring waits ({:.2f} ms)"
+                     , label, megabytes, regions, batches, seconds > 0 ? megabytes / seconds : 0.0
+                     , dedicatedBuffers, ringWaits, duration<double, std::milli>(ringWaitTime).count());
+    }
+
+    void UploadEngine::init(VkDevice device, VmaMemoryAllocator &allocator, const Queue& transfer, const Queue& graphics
+                            , VkDeviceSize capacity) {
+        m_device = device;
+        m_allocator = &allocator;
+        m_transfer = transfer;
+        m_graphics = graphics;
+        m_capacity = capacity;
+
+        auto poolInfo = makeStruct<VkCommandPoolCreateInfo>();
+        poolInfo.queueFamilyIndex = m_transfer.familyIndex;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT | VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        CHECK_VULKAN(vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_commandPool));
+
+        auto typeInfo = makeStruct<VkSemaphoreTypeCreateInfo>();
+        typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+        typeInfo.initialValue = 0;
+        auto semaphoreInfo = makeStruct<VkSemaphoreCreateInfo>();
+        semaphoreInfo.pNext = &typeInfo;
+        CHECK_VULKAN(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_timeline));
+
+        if(crossFamily()) {
+            poolInfo.queueFamilyIndex = m_graphics.familyIndex;
+            CHECK_VULKAN(vkCreateCommandPool(m_device, &poolInfo, nullptr, &m_acquirePool));
+            CHECK_VULKAN(vkCreateSemaphore(m_device, &semaphoreInfo, nullptr, &m_transferTimeline));
+        }
+
+        auto bufferInfo = makeStruct<VkBufferCreateInfo>();
+        bufferInfo.size = m_capacity;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        m_ring = m_allocator->allocate(bufferInfo, VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        m_ringData = reinterpret_cast<std::byte*>(m_ring.mapped);
+
+        spdlog::info("upload engine initialized with {} MB staging ring on queue family {}{}"
+                     , m_capacity / (1024 * 1024), m_transfer.familyIndex, crossFamily() ? " (dedicated)" : "");
+    }
+
+    void UploadEngine::shutdown() {
+        if(!m_device) return;
+
+        if(m_recording) {
+            submit();
+        }
+        waitValue(m_submitted);
+        collect();
+
+        for(auto& buffer : m_dedicated) {
+            m_allocator->deallocate(buffer);
+        }
+        m_dedicated.clear();
+        m_allocator->deallocate(m_ring);
+        vkDestroySemaphore(m_device, m_timeline, nullptr);
+        vkDestroyCommandPool(m_device, m_commandPool, nullptr);
+        if(crossFamily()) {
+            vkDestroySemaphore(m_device, m_transferTimeline, nullptr);
+            vkDestroyCommandPool(m_device, m_acquirePool, nullptr);
+        }
+        m_device = VK_NULL_HANDLE;
+    }
+
+    StagingAllocation UploadEngine::stage(VkDeviceSize size, VkDeviceSize alignment) {
+        if(size > m_capacity) {
+            return dedicated(size);
+        }
+
+        while(true) {
+            auto offset = alignUp(m_head, alignment);
+            if(offset % m_capacity + size > m_capacity) {
+                offset = alignUp(offset, m_capacity);   // doesn't fit before the end of the ring, wrap around
+            }
+
+            if(offset + size - m_tail <= m_capacity) {
+                m_head = offset + size;
+                const auto ringOffset = offset % m_capacity;
+
+                // staged memory belongs to the open batch and is reclaimed once it completes
+                commandBuffer();
+                return { m_ring._, ringOffset, size, m_ringData + ringOffset };
+            }
+
+            // ring is full, reclaim space from completed batches or wait for the oldest one
+            collect();
+            if(!m_inFlight.empty()) {
+                const auto start = UploadStats::Clock::now();
+                waitValue(m_inFlight.front().value);
+                collect();
+                ++m_stats.ringWaits;
+                m_stats.ringWaitTime += UploadStats::Clock::now() - start;
+            } else if(m_recording && m_recordedEnd > m_tail) {
+                submit();
+            } else if(m_head == m_tail) {
+                m_head = m_tail = m_recordedEnd = 0;
+            } else {
+                // the rest of the ring is staged for copies that have not been recorded yet
+                return dedicated(size);
+            }
+        }
+    }
+
+    StagingAllocation UploadEngine::stage(const void *data, VkDeviceSize size) {
+        auto allocation = stage(size);
+        std::memcpy(allocation.data, data, size);
+        return allocation;
+    }
+
+    StagingAllocation UploadEngine::dedicated(VkDeviceSize size) {
+        auto bufferInfo = makeStruct<VkBufferCreateInfo>();
+        bufferInfo.size = size;
+        bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        auto buffer = m_allocator->allocate(bufferInfo, VMA_MEMORY_USAGE_CPU_ONLY, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        m_dedicated.push_back(buffer);
+        ++m_stats.dedicatedBuffers;
+        commandBuffer();
+
+        return { buffer._, 0, size, reinterpret_cast<std::byte*>(buffer.mapped) };
+    }
+
+    void UploadEngine::copy(const StagingAllocation &source, VkBuffer destination, VkDeviceSize dstOffset) {
+        VkBufferCopy region{ source.offset, dstOffset, source.size };
+        copy(source.buffer, destination, { &region, 1 });
+    }
+
+    void UploadEngine::copy(VkBuffer source, VkBuffer destination, std::span<const VkBufferCopy> regions) {
+        auto commandBuffer = this->commandBuffer();
+        vkCmdCopyBuffer(commandBuffer, source, destination, regions.size(), regions.data());
+        m_recordedEnd = m_head;
+        for(const auto& region : regions) {
+            m_stats.bytes += region.size;
+        }
+        m_stats.regions += regions.size();
+
+        const auto transfer = ownership();
+        if(transfer.required()) {
+            auto release = transfer.release(destination, VK_ACCESS_TRANSFER_WRITE_BIT);
+            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+                                 , 0, 0, nullptr, 1, &release, 0, nullptr);
+            m_bufferAcquires.push_back(transfer.acquire(destination, VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT));
+        }
+    }
+
+    void UploadEngine::copyToImage(const StagingAllocation &source, VkImage image, std::span<const VkBufferImageCopy> regions
+                                   , const VkImageSubresourceRange &range, VkImageLayout oldLayout, VkImageLayout newLayout) {
+        auto commandBuffer = this->commandBuffer();
+        const auto transfer = ownership();
+
+        auto barrier = makeStruct<VkImageMemoryBarrier>();
+        barrier.srcAccessMask = VK_ACCESS_NONE;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        // without acquiring the image from the graphics family its contents are undefined on the transfer queue anyway
+        barrier.oldLayout = transfer.required() ? VK_IMAGE_LAYOUT_UNDEFINED : oldLayout;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = range;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT
+                             , 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        // region offsets are relative to the staging allocation
+        static constexpr uint32_t MaxRegions{16};
+        assert(regions.size() <= MaxRegions);
+        std::array<VkBufferImageCopy, MaxRegions> copies{};
+        for(auto i = 0u; i < regions.size(); ++i) {
+            copies[i] = regions[i];
+            copies[i].bufferOffset += source.offset;
+        }
+        m_stats.bytes += source.size;
+        vkCmdCopyBufferToImage(commandBuffer, source.buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, regions.size(), copies.data());
+        m_stats.regions += regions.size();
+        m_recordedEnd = m_head;
+
+        barrier = transfer.release(image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, newLayout, VK_ACCESS_TRANSFER_WRITE_BIT);
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT
+                             , 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+        if(transfer.required()) {
+            m_imageAcquires.push_back(transfer.acquire(image, range, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, newLayout
+                                                       , VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT));
+        }
+    }
+
+    VkCommandBuffer UploadEngine::commandBuffer() {
+        if(!m_recording) {
+            m_recording = allocate(m_device, m_commandPool, m_freeCommandBuffers);
+        }
+        return m_recording;
+    }
+
+    VkCommandBuffer UploadEngine::acquireCommandBuffer() {
+        auto commandBuffer = allocate(m_device, m_acquirePool, m_freeAcquireCommandBuffers);
+
+        // everything submitted to the graphics queue after the acquire sees the batch's writes
+        auto barrier = makeStruct<VkMemoryBarrier>();
+        barrier.srcAccessMask = VK_ACCESS_MEMORY_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0
+                             , 1, &barrier
+                             , m_bufferAcquires.size(), m_bufferAcquires.data()
+                             , m_imageAcquires.size(), m_imageAcquires.data());
+        CHECK_VULKAN(vkEndCommandBuffer(commandBuffer));
+
+        m_bufferAcquires.clear();
+        m_imageAcquires.clear();
+        return commandBuffer;
+    }
+
+    VkCommandBuffer UploadEngine::allocate(VkDevice device, VkCommandPool pool, std::vector<VkCommandBuffer>& freeList) {
+        VkCommandBuffer commandBuffer;
+        if(freeList.empty()) {
+            auto allocateInfo = makeStruct<VkCommandBufferAllocateInfo>();
+            allocateInfo.commandPool = pool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            CHECK_VULKAN(vkAllocateCommandBuffers(device, &allocateInfo, &commandBuffer));
+        }else {
+            commandBuffer = freeList.back();
+            freeList.pop_back();
+            CHECK_VULKAN(vkResetCommandBuffer(commandBuffer, 0));
+        }
+
+        auto beginInfo = makeStruct<VkCommandBufferBeginInfo>();
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        CHECK_VULKAN(vkBeginCommandBuffer(commandBuffer, &beginInfo));
+        return commandBuffer;
+    }
+
+    UploadToken UploadEngine::submit(std::span<const WaitSemaphore> waits, std::span<const VkSemaphore> signals) {
+        if(!m_recording && waits.empty() && signals.empty()) {
+            return last();
+        }
+        auto commandBuffer = this->commandBuffer();
+
+        // make the batch's writes visible to everything submitted after it on this queue
+        auto barrier = makeStruct<VkMemoryBarrier>();
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+        vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT
+                             , 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        CHECK_VULKAN(vkEndCommandBuffer(commandBuffer));
+
+        const auto value = m_submitted + 1;
+
+        // submissions can happen mid-frame, so the semaphore lists live on the stack
+        if(waits.size() > MaxWaitSemaphores || signals.size() > MaxSignalSemaphores) {
+            THROW(std::format("upload batch with {} waits and {} signals, at most {} and {} supported"
+                              , waits.size(), signals.size(), MaxWaitSemaphores, MaxSignalSemaphores))
+        }
+        std::array<VkSemaphore, MaxWaitSemaphores> waitSemaphores{};
+        std::array<VkPipelineStageFlags, MaxWaitSemaphores> waitStages{};
+        std::array<uint64_t, MaxWaitSemaphores> waitValues{};
+        uint32_t waitCount = 0;
+        for(const auto& wait : waits) {
+            waitSemaphores[waitCount] = wait._;
+            waitStages[waitCount] = wait.stage;
+            waitValues[waitCount] = wait.value;
+            ++waitCount;
+        }
+        std::array<VkSemaphore, MaxSignalSemaphores + 1> signalSemaphores{};
+        std::array<uint64_t, MaxSignalSemaphores + 1> signalValues{};
+        uint32_t signalCount = 0;
+        for(const auto semaphore : signals) {
+            signalSemaphores[signalCount++] = semaphore;
+        }
+        signalSemaphores[signalCount] = m_timeline;
+        signalValues[signalCount] = value;
+        ++signalCount;
+
+        VkCommandBuffer acquireCommandBuffer{};
+        if(crossFamily()) {
+            // the transfer submission only signals the acquire, the acquire signals everything else
+            VkPipelineStageFlags acquireStage = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+            VkSemaphore transferSignal = m_transferTimeline;
+
+            auto timelineInfo = makeStruct<VkTimelineSemaphoreSubmitInfo>();
+            timelineInfo.waitSemaphoreValueCount = waitCount;
+            timelineInfo.pWaitSemaphoreValues = waitValues.data();
+            timelineInfo.signalSemaphoreValueCount = 1;
+            timelineInfo.pSignalSemaphoreValues = &value;
+
+            auto submitInfo = makeStruct<VkSubmitInfo>();
+            submitInfo.pNext = &timelineInfo;
+            submitInfo.waitSemaphoreCount = waitCount;
+            submitInfo.pWaitSemaphores = waitSemaphores.data();
+            submitInfo.pWaitDstStageMask = waitStages.data();
+            submitInfo.commandBufferCount = 1;
+            submitInfo.pCommandBuffers = &commandBuffer;
+            submitInfo.signalSemaphoreCount = 1;
+            submitInfo.pSignalSemaphores = &transferSignal;
+            CHECK_VULKAN(vkQueueSubmit(m_transfer._, 1, &submitInfo, VK_NULL_HANDLE));
+
+            acquireCommandBuffer = this->acquireCommandBuffer();
+            waitSemaphores[0] = m_transferTimeline;
+            waitStages[0] = acquireStage;
+            waitValues[0] = value;
+            waitCount = 1;
+            commandBuffer = acquireCommandBuffer;
+        }
+
+        auto timelineInfo = makeStruct<VkTimelineSemaphoreSubmitInfo>();
+        timelineInfo.waitSemaphoreValueCount = waitCount;
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = signalCount;
+        timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+        auto submitInfo = makeStruct<VkSubmitInfo>();
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.waitSemaphoreCount = waitCount;
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.signalSemaphoreCount = signalCount;
+        submitInfo.pSignalSemaphores = signalSemaphores.data();
+        CHECK_VULKAN(vkQueueSubmit(crossFamily() ? m_graphics._ : m_transfer._, 1, &submitInfo, VK_NULL_HANDLE));
+
+        if(m_stats.batches++ == 0) {
+            m_stats.firstSubmit = UploadStats::Clock::now();
+        }
+        m_submitted = value;
+        // staging memory allocated after the last recorded copy stays with the next batch
+        m_inFlight.push_back({ m_recording, acquireCommandBuffer, value, m_recordedEnd, std::move(m_dedicated) });
+        m_dedicated.clear();
+        m_recording = VK_NULL_HANDLE;
+
+        return { value };
+    }
+
+    bool UploadEngine::isComplete(UploadToken token) const {
+        uint64_t completed{};
+        vkGetSemaphoreCounterValue(m_device, m_timeline, &completed);
+        return token.value <= completed;
+    }
+
+    void UploadEngine::wait(UploadToken token) {
+        if(!token.valid()) return;
+        if(token.value > m_submitted && m_recording) {
+            submit();   // token of the open batch
+        }
+        waitValue(token.value);
+        collect();
+    }
+
+    void UploadEngine::waitValue(uint64_t value) {
+        auto waitInfo = makeStruct<VkSemaphoreWaitInfo>();
+        waitInfo.semaphoreCount = 1;
+        waitInfo.pSemaphores = &m_timeline;
+        waitInfo.pValues = &value;
+        CHECK_VULKAN(vkWaitSemaphores(m_device, &waitInfo, UINT64_MAX));
+    }
+
+    void UploadEngine::collect() {
+        if(m_inFlight.empty()) return;
+
+        uint64_t completed{};
+        vkGetSemaphoreCounterValue(m_device, m_timeline, &completed);
+
+        while(!m_inFlight.empty() && m_inFlight.front().value <= completed) {
+            auto& batch = m_inFlight.front();
+            m_tail = batch.ringEnd;
+            for(auto& buffer : batch.dedicated) {
+                m_allocator->deallocate(buffer);
+            }
+            m_freeCommandBuffers.push_back(batch.commandBuffer);
+            if(batch.acquireCommandBuffer) {
+                m_freeAcquireCommandBuffers.push_back(batch.acquireCommandBuffer);
+            }
+            m_inFlight.pop_front();
+            m_stats.lastCompletion = UploadStats::Clock::now();
+        }
+    }
+}
@@ -25,15 +25,17 @@ namespace vr {
         }
     }
 
-    Buffer VmaMemoryAllocator::allocate(VkBufferCreateInfo createInfo, VmaMemoryUsage usage) {
+    Buffer VmaMemoryAllocator::allocate(VkBufferCreateInfo createInfo, VmaMemoryUsage usage, VmaAllocationCreateFlags flags) {
         VmaAllocationCreateInfo allocInfo{};
         allocInfo.usage = usage;
+        allocInfo.flags = flags;
 
         VkBuffer buffer;
         VmaAllocation allocation;
-        CHECK_VULKAN(vmaCreateBuffer(allocator, &createInfo, &allocInfo, &buffer, &allocation, nullptr));
+        VmaAllocationInfo allocationInfo{};
+        CHECK_VULKAN(vmaCreateBuffer(allocator, &createInfo, &allocInfo, &buffer, &allocation, &allocationInfo));
 
-        return { buffer, createInfo, allocation };
+        return { buffer, createInfo, allocation, allocationInfo.pMappedData };
     }
 
     Image VmaMemoryAllocator::allocate(VkImageCreateInfo createInfo, VmaMemoryUsage usage) {
@@ -1,6 +1,11 @@
 #include "check.hpp"
 #include "vr/graphics/vulkan/VulkanGraphicsService.hpp"
 #include "io/FileReader.hpp"
+#include "util/HeapGuard.hpp"
+
+#include <optional>
+#include <algorithm>
+#include <type_traits>
 
 namespace vr {
 
@@ -11,11 +16,18 @@ namespace vr {
     }
 
     void VulkanGraphicsService::init() {
+        m_initStart = std::chrono::steady_clock::now();
         pickDevice();
         setupQueues();
         createDevice();
         initMemoryAllocator();
         createInternalCommandPool();
+        createFrameContexts();
+        m_retired.reserve(RetiredCapacity);    // releases mid-session should not grow it
+        createFrameRing();
+        createLinkPool();
+        createPipelineCache();
+        m_uploads.init(m_device, allocator, m_transferQueue, graphicsQueue());
         initializeGraphicsBinding();
         logDevice();
     }
@@ -32,23 +44,55 @@ namespace vr {
         assert(m_physicalDevice != VK_NULL_HANDLE);
         auto queueFamilies = get<VkQueueFamilyProperties>(m_physicalDevice, vkGetPhysicalDeviceQueueFamilyProperties);
 
-        for(auto i = 0; i < queueFamilies.size(); i++) {
-            const auto& queueFamily = queueFamilies[i];
-            if((queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) == VK_QUEUE_GRAPHICS_BIT) {
-                m_graphicsFamilyIndex = i;
-                break;
+        auto find = [&](VkQueueFlags required, VkQueueFlags excluded) -> std::optional<uint32_t> {
+            for(auto i = 0u; i < queueFamilies.size(); i++) {
+                const auto& queueFamily = queueFamilies[i];
+                if((queueFamily.queueFlags & required) == required && (queueFamily.queueFlags & excluded) == 0) {
+                    return i;
+                }
             }
+            return {};
+        };
+
+        auto graphics = find(VK_QUEUE_GRAPHICS_BIT, 0);
+        if(!graphics) {
+            THROW("device has no graphics queue");
+        }
+        m_graphicsFamilyIndex = *graphics;
+
+        // transfer queues with a coarse image granularity can only copy whole mip levels
+        auto transfer = find(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+        if(!transfer) {
+            transfer = find(VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT);
         }
+        if(transfer) {
+            const auto granularity = queueFamilies[*transfer].minImageTransferGranularity;
+            if(granularity.width != 1 || granularity.height != 1 || granularity.depth != 1) {
+                transfer.reset();
+            }
+        }
+
+        auto compute = find(VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+
+        m_transferQueue.familyIndex = transfer.value_or(m_graphicsFamilyIndex);
+        m_computeQueue.familyIndex = compute.value_or(m_graphicsFamilyIndex);
     }
 
     void VulkanGraphicsService::createDevice() {
         assert(m_physicalDevice != VK_NULL_HANDLE);
         auto xrInstance = context().instance;
         auto priority = 1.f;
-        VkDeviceQueueCreateInfo queueCreateInfo{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
-        queueCreateInfo.queueFamilyIndex = m_graphicsFamilyIndex;
-        queueCreateInfo.queueCount = 1;
-        queueCreateInfo.pQueuePriorities = &priority;
+        std::vector<VkDeviceQueueCreateInfo> queueCreateInfos;
+        for(auto familyIndex : { m_graphicsFamilyIndex, m_transferQueue.familyIndex, m_computeQueue.familyIndex }) {
+            auto duplicate = std::ranges::any_of(queueCreateInfos, [&](const auto& info){ return info.queueFamilyIndex == familyIndex; });
+            if(duplicate) continue;
+
+            VkDeviceQueueCreateInfo queueCreateInfo{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO };
+            queueCreateInfo.queueFamilyIndex = familyIndex;
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = &priority;
+            queueCreateInfos.push_back(queueCreateInfo);
+        }
 
         std::vector<const char*> extensions{
             VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
@@ -58,13 +102,17 @@ namespace vr {
 #endif
         };
 
+        auto timelineSemaphoreFeatures = makeStruct<VkPhysicalDeviceTimelineSemaphoreFeatures>();
+        timelineSemaphoreFeatures.timelineSemaphore = VK_TRUE;
+
         auto dynamicRenderingFeatures = makeStruct<VkPhysicalDeviceDynamicRenderingFeatures>();
+        dynamicRenderingFeatures.pNext = &timelineSemaphoreFeatures;
         dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
 
         VkDeviceCreateInfo createDeviceInfo{ VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
         createDeviceInfo.pNext = &dynamicRenderingFeatures;
-        createDeviceInfo.queueCreateInfoCount = 1;
-        createDeviceInfo.pQueueCreateInfos = &queueCreateInfo;
+        createDeviceInfo.queueCreateInfoCount = queueCreateInfos.size();
+        createDeviceInfo.pQueueCreateInfos = queueCreateInfos.data();
 
         auto createInfo = makeStruct<XrVulkanDeviceCreateInfoKHR>();
         createInfo.systemId = context().systemId;
@@ -79,6 +127,8 @@ namespace vr {
         LOG_ERROR(xrInstance, xrCreateVulkanDeviceKHR(xrInstance, &createInfo, &m_device, &result));
 
         vkGetDeviceQueue(m_device, m_graphicsFamilyIndex, 0, &m_graphicsQueue);
+        vkGetDeviceQueue(m_device, m_transferQueue.familyIndex, 0, &m_transferQueue._);
+        vkGetDeviceQueue(m_device, m_computeQueue.familyIndex, 0, &m_computeQueue._);
     }
 
     void VulkanGraphicsService::createInternalCommandPool() {
@@ -89,8 +139,144 @@ namespace vr {
 
         CHECK_VULKAN(vkCreateCommandPool(m_device, &createInfo, VK_NULL_HANDLE, &m_commandPool));
 
-        createInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
-        CHECK_VULKAN(vkCreateCommandPool(m_device, &createInfo, VK_NULL_HANDLE, &m_scopedCommandPool));
+        auto fenceInfo = makeStruct<VkFenceCreateInfo>();
+        CHECK_VULKAN(vkCreateFence(m_device, &fenceInfo, nullptr, &m_scopedFence));
+    }
+
+    void VulkanGraphicsService::createFrameContexts() {
+        auto poolInfo = makeStruct<VkCommandPoolCreateInfo>();
+        poolInfo.queueFamilyIndex = m_graphicsFamilyIndex;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+        auto fenceInfo = makeStruct<VkFenceCreateInfo>();
+
+        for(auto i = 0u; i < MaxFramesInFlight; ++i) {
+            auto& frameContext = m_frameContexts[i];
+            CHECK_VULKAN(vkCreateCommandPool(m_device, &poolInfo, nullptr, &frameContext.commandPool));
+            CHECK_VULKAN(vkCreateFence(m_device, &fenceInfo, nullptr, &frameContext.fence));
+            name<VK_OBJECT_TYPE_FENCE>(frameContext.fence, std::format("frame_fence_{}", i));
+        }
+    }
+
+    void VulkanGraphicsService::createFrameRing() {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+        const auto& limits = properties.limits;
+        m_offsetAlignment = std::max({ limits.minUniformBufferOffsetAlignment, limits.minStorageBufferOffsetAlignment, VkDeviceSize{16} });
+
+        constexpr auto usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+        auto buffer = createPersistentlyMappedBuffer(FrameRing::DefaultCapacity * MaxFramesInFlight, usage);
+        name<VK_OBJECT_TYPE_BUFFER>(buffer._, "frame_ring");
+        m_frameRing.init(allocator.allocator, buffer, MaxFramesInFlight, FrameRing::DefaultCapacity, m_offsetAlignment);
+    }
+
+    void VulkanGraphicsService::createLinkPool() {
+        m_links.init(m_offsetAlignment, [this](VkDeviceSize size) {
+            auto block = createPersistentlyMappedBuffer(size, LinkPool::Usage);
+            name<VK_OBJECT_TYPE_BUFFER>(block._, "link_block");
+            return block;
+        });
+    }
+
+    void VulkanGraphicsService::createPipelineCache() {
+        VkPhysicalDeviceProperties properties{};
+        vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+        m_pipelineCache.init(m_device, properties);
+    }
+
+    LinkAllocation VulkanGraphicsService::allocateLink(VkDeviceSize size) {
+        if(size <= LinkPool::MaxSlotSize) {
+            return m_links.allocate(size);
+        }
+
+        auto buffer = createPersistentlyMappedBuffer(size, LinkPool::Usage);
+        auto& stats = m_links.stats();
+        ++stats.links;
+        ++stats.dedicated;
+        ++stats.allocations;
+        stats.requestedBytes += size;
+        stats.reservedBytes += size;
+        return { buffer._, 0, size, static_cast<std::byte*>(buffer.mapped), { 0, 0, size, buffer.id } };
+    }
+
+    void VulkanGraphicsService::releaseLink(const LinkSlot &slot, UploadToken after) {
+        if(!slot.dedicated.valid()) {
+            retire(slot, after);
+            return;
+        }
+
+        Buffer buffer{};
+        buffer.id = slot.dedicated;
+        release(buffer, after);
+
+        auto& stats = m_links.stats();
+        --stats.links;
+        --stats.dedicated;
+        stats.requestedBytes -= slot.size;
+        stats.reservedBytes -= slot.size;
+    }
+
+    void VulkanGraphicsService::beginFrame() {
+        m_frameIndex = static_cast<uint32_t>(m_frameCount++ % MaxFramesInFlight);
+        auto& frameContext = m_frameContexts[m_frameIndex];
+
+        // renderers have created their pipelines by now, which is what cold and warm starts differ in
+        if(m_frameCount == 1) {
+            const auto sinceInit = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_initStart);
+            spdlog::info("first frame {:.1f} ms after graphics init", sinceInit.count());
+            m_pipelineCache.stats().log("first frame");
+        }
+
+        // only block when the slot we are about to reuse still has work on the GPU
+        if(frameContext.inFlight) {
+            CHECK_VULKAN(vkWaitForFences(m_device, 1, &frameContext.fence, VK_TRUE, UINT64_MAX));
+            CHECK_VULKAN(vkResetFences(m_device, 1, &frameContext.fence));
+            frameContext.inFlight = false;
+            m_completedFrame = std::max(m_completedFrame, frameContext.frame);
+        }
+        CHECK_VULKAN(vkResetCommandPool(m_device, frameContext.commandPool, 0));
+        frameContext.numUsed = 0;
+        m_frameRing.begin(m_frameIndex);
+        m_latched = false;
+
+        // uploads recorded between frames go out before any of this frame's work
+        m_uploads.submit();
+        m_uploads.collect();
+        reclaim();
+    }
+
+    void VulkanGraphicsService::endFrame() {
+        auto& frameContext = m_frameContexts[m_frameIndex];
+
+        // an empty submission signals the fence once all previously submitted work has completed
+        CHECK_VULKAN(vkQueueSubmit(m_graphicsQueue, 0, nullptr, frameContext.fence));
+        frameContext.frame = m_frameCount;
+        frameContext.inFlight = true;
+    }
+
+    void VulkanGraphicsService::flush() {
+        m_uploads.wait(m_uploads.submit());
+        m_uploads.stats().log("flush");
+    }
+
+    std::span<VkCommandBuffer> VulkanGraphicsService::frameCommandBuffers(uint32_t count) {
+        auto& frameContext = m_frameContexts[m_frameIndex];
+        if(frameContext.numUsed + count > FrameContext::MaxCommandBuffers) {
+            THROW(std::format("{} command buffers requested, at most {} available per frame", frameContext.numUsed + count, FrameContext::MaxCommandBuffers));
+        }
+
+        if(frameContext.numUsed + count > frameContext.numAllocated) {
+            auto allocateInfo = makeStruct<VkCommandBufferAllocateInfo>();
+            allocateInfo.commandPool = frameContext.commandPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = frameContext.numUsed + count - frameContext.numAllocated;
+            CHECK_VULKAN(vkAllocateCommandBuffers(m_device, &allocateInfo, frameContext.commandBuffers.data() + frameContext.numAllocated));
+            frameContext.numAllocated += allocateInfo.commandBufferCount;
+        }
+
+        std::span<VkCommandBuffer> commandBuffers{ frameContext.commandBuffers.data() + frameContext.numUsed, count };
+        frameContext.numUsed += count;
+        return commandBuffers;
     }
 
     void VulkanGraphicsService::initMemoryAllocator() {
@@ -120,6 +306,10 @@ namespace vr {
                 , VK_VERSION_PATCH(apiVersion)
                 , properties.deviceName );
         spdlog::info("{}", ss.str());
+        spdlog::info("queue families: graphics {}, transfer {}{}, compute {}{}"
+                     , m_graphicsFamilyIndex
+                     , m_transferQueue.familyIndex, m_transferQueue.familyIndex == m_graphicsFamilyIndex ? " (shared)" : ""
+                     , m_computeQueue.familyIndex, m_computeQueue.familyIndex == m_graphicsFamilyIndex ? " (shared)" : "");
     }
 
     const VulkanContext &VulkanGraphicsService::vulkanContext() const {
@@ -142,8 +332,7 @@ namespace vr {
         createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         auto buffer = allocator.allocate(createInfo, VMA_MEMORY_USAGE_CPU_ONLY);
-        m_buffers.push_back(buffer);
-        return buffer;
+        return track(buffer);
     }
 
     Buffer VulkanGraphicsService::createDeviceLocalBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
@@ -153,8 +342,7 @@ namespace vr {
         createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         auto buffer =  allocator.allocate(createInfo, VMA_MEMORY_USAGE_GPU_ONLY);
-        m_buffers.push_back(buffer);
-        return buffer;
+        return track(buffer);
     }
 
     Buffer VulkanGraphicsService::createMappableBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
@@ -164,24 +352,129 @@ namespace vr {
         createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
         auto buffer = allocator.allocate(createInfo, VMA_MEMORY_USAGE_CPU_TO_GPU);
-        m_buffers.push_back(buffer);
+        return track(buffer);
+    }
+
+    Buffer VulkanGraphicsService::createPersistentlyMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+        auto createInfo = makeStruct<VkBufferCreateInfo>();
+        createInfo.size = size;
+        createInfo.usage = usage;
+        createInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        auto buffer = allocator.allocate(createInfo, VMA_MEMORY_USAGE_CPU_TO_GPU, VMA_ALLOCATION_CREATE_MAPPED_BIT);
+        return track(buffer);
+    }
+
+    Buffer VulkanGraphicsService::track(Buffer buffer) {
+        buffer.id = m_buffers.insert({ buffer, {} });
+        m_buffers[buffer.id].buffer.id = buffer.id;
         return buffer;
     }
 
-    void VulkanGraphicsService::release(Buffer buffer) {
-        auto mappingItr = std::find_if(m_mappings.begin(), m_mappings.end(), [&buffer](const auto& mapping){
-            return mapping.allocation == buffer.allocation;
-        });
-        if(mappingItr != m_mappings.end()) {
-            mappingItr->unmap();
-            m_mappings.erase(mappingItr);
+    void VulkanGraphicsService::release(Buffer buffer, UploadToken after) {
+        auto tracked = m_buffers.erase(buffer.id);
+        assert(tracked.has_value());
+        if(tracked) {
+            retire(std::move(*tracked), after);
         }
-        auto itr = std::find_if(m_buffers.begin(), m_buffers.end(), [&buffer](const auto& buf) {
-            return buf._ == buffer._;
-        });
-        assert(itr != m_buffers.end());
-        m_buffers.erase(itr);
-        allocator.deallocate(buffer);
+    }
+
+    void VulkanGraphicsService::release(const Image& image, UploadToken after) {
+        if(auto tracked = m_images.erase(image.id)) {
+            retire(std::move(*tracked), after);
+        }
+    }
+
+    void VulkanGraphicsService::retire(RetiredObject object, UploadToken after) {
+        // the frame being recorded may still use it, m_frameCount is that frame's number
+        m_retired.push_back({ m_frameCount, after, std::move(object) });
+    }
+
+    void VulkanGraphicsService::reclaim(bool force) {
+        if(m_retired.empty()) return;
+
+        // retired objects are in frame order, but upload tokens may complete out of it
+        size_t kept = 0;
+        for(size_t i = 0; i < m_retired.size(); ++i) {
+            auto& retired = m_retired[i];
+            const auto done = force || (retired.frame <= m_completedFrame
+                                        && (!retired.upload.valid() || m_uploads.isComplete(retired.upload)));
+            if(done) {
+                std::visit([this](auto& object){ destroy(object); }, retired.object);
+            } else if(kept++ != i) {
+                m_retired[kept - 1] = std::move(retired);
+            }
+        }
+        m_retired.erase(m_retired.begin() + static_cast<ptrdiff_t>(kept), m_retired.end());
+    }
+
+    void VulkanGraphicsService::destroy(TrackedBuffer& tracked) {
+        tracked.mapping.unmap();
+        allocator.deallocate(tracked.buffer);
+    }
+
+    void VulkanGraphicsService::destroy(const Image& image) {
+        allocator.deallocate(image);
+    }
+
+    void VulkanGraphicsService::destroy(const LinkSlot& slot) {
+        m_links.free(slot);
+    }
+
+    ResourceCounts VulkanGraphicsService::liveResources() const {
+        ResourceCounts counts{};
+        counts.buffers = m_buffers.size();
+        for(const auto& tracked : m_buffers) {
+            counts.mappings += tracked.mapping._ ? 1 : 0;
+        }
+        counts.images = m_images.size();
+        counts.imageViews = resources<VkImageView>().size();
+        counts.shaderModules = resources<VkShaderModule>().size();
+        counts.pipelines = resources<VkPipeline>().size();
+        counts.pipelineLayouts = resources<VkPipelineLayout>().size();
+        counts.descriptorSetLayouts = resources<VkDescriptorSetLayout>().size();
+        counts.descriptorPools = resources<VkDescriptorPool>().size();
+        counts.renderPasses = resources<VkRenderPass>().size();
+        counts.frameBuffers = resources<VkFramebuffer>().size();
+        counts.commandPools = resources<VkCommandPool>().size();
+        counts.retired = m_retired.size();
+        return counts;
+    }
+
+    void VulkanGraphicsService::destroy(VkImageView view) {
+        vkDestroyImageView(m_device, view, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkShaderModule shaderModule) {
+        vkDestroyShaderModule(m_device, shaderModule, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkPipeline pipeline) {
+        vkDestroyPipeline(m_device, pipeline, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkPipelineLayout layout) {
+        vkDestroyPipelineLayout(m_device, layout, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkDescriptorSetLayout setLayout) {
+        vkDestroyDescriptorSetLayout(m_device, setLayout, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkDescriptorPool pool) {
+        vkDestroyDescriptorPool(m_device, pool, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkRenderPass renderPass) {
+        vkDestroyRenderPass(m_device, renderPass, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkFramebuffer frameBuffer) {
+        vkDestroyFramebuffer(m_device, frameBuffer, nullptr);
+    }
+
+    void VulkanGraphicsService::destroy(VkCommandPool commandPool) {
+        vkDestroyCommandPool(m_device, commandPool, nullptr);
     }
 
     VkCommandBuffer VulkanGraphicsService::commandBuffer(uint32_t imageIndex) {
@@ -224,74 +517,48 @@ namespace vr {
         return *itr;
     }
 
-    VkImageView VulkanGraphicsService::createImageView(VkImageViewCreateInfo createInfo) {
+    Resource<VkImageView> VulkanGraphicsService::createImageView(VkImageViewCreateInfo createInfo) {
         VkImageView view;
-        vkCreateImageView(m_device, &createInfo, nullptr, &view);
-        m_imageViews.push_back(view);
-        return view;
+        CHECK_VULKAN(vkCreateImageView(m_device, &createInfo, nullptr, &view));
+        return track(view);
     }
 
-    void VulkanGraphicsService::copyToImage(const CopyRequest &request) {
+    UploadToken VulkanGraphicsService::copyToImage(const CopyRequest &request) {
         const auto& swapChain = getSwapChain(request.imageId.swapChain);
         auto image = swapChain.images[request.imageId.imageIndex].image;
 
-        scoped([&](VkCommandBuffer commandBuffer) {
-            auto barrier = makeStruct<VkImageMemoryBarrier>();
-            barrier.srcAccessMask = VK_ACCESS_NONE;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.image = image;
-            barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            barrier.subresourceRange.baseMipLevel = request.mipLevel;
-            barrier.subresourceRange.levelCount = 1;
-            barrier.subresourceRange.baseArrayLayer = request.arrayLayer;
-            barrier.subresourceRange.layerCount = 1;
+        VkBufferImageCopy region{0, 0, 0};
+        region.imageOffset = {0, 0, 0};
+        region.imageExtent = {swapChain.width, swapChain.height, 1};
+        region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        region.imageSubresource.mipLevel = request.mipLevel;
+        region.imageSubresource.baseArrayLayer = request.arrayLayer;
+        region.imageSubresource.layerCount = 1;
 
-            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-                                 VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0,
-                                 nullptr, 0, nullptr, 1, &barrier);
-
-            VkBufferImageCopy region{0, 0, 0};
-            region.imageOffset = {0, 0, 0};
-            region.imageExtent = {swapChain.width, swapChain.height, 1};
-            region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-            region.imageSubresource.mipLevel = request.mipLevel;
-            region.imageSubresource.baseArrayLayer = request.arrayLayer;
-            region.imageSubresource.layerCount = 1;
-            vkCmdCopyBufferToImage(commandBuffer, request.source._, image,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_NONE;
-            barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
-            barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, request.mipLevel, 1, request.arrayLayer, 1};
+        StagingAllocation source{ request.source._, 0, request.source.info.size };
 
-            vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
-                                 VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, 0,
-                                 nullptr, 0, nullptr, 1, &barrier);
-        });
+        m_uploads.copyToImage(source, image, { &region, 1 }, range
+                              , VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        return m_uploads.open();
     }
 
-    VkDescriptorPool VulkanGraphicsService::createDescriptorPool(const VkDescriptorPoolCreateInfo &createInfo) {
+    Resource<VkDescriptorPool> VulkanGraphicsService::createDescriptorPool(const VkDescriptorPoolCreateInfo &createInfo) {
         VkDescriptorPool pool;
         CHECK_VULKAN(vkCreateDescriptorPool(m_device, &createInfo, nullptr, &pool));
-        m_descriptorPools.push_back(pool);
-        return pool;
+        return track(pool);
     }
 
-    VkDescriptorSetLayout VulkanGraphicsService::createDescriptorSetLayout(VkDescriptorSetLayoutCreateInfo createInfo) {
+    Resource<VkDescriptorSetLayout> VulkanGraphicsService::createDescriptorSetLayout(VkDescriptorSetLayoutCreateInfo createInfo) {
         VkDescriptorSetLayout setLayout;
         CHECK_VULKAN(vkCreateDescriptorSetLayout(m_device, &createInfo, nullptr, &setLayout));
-        m_descriptorSetLayouts.push_back(setLayout);
-        return setLayout;
+        return track(setLayout);
     }
 
-    void VulkanGraphicsService::copy(const Buffer &src, const Buffer &dst, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
-        scoped([&](auto commandBuffer){
-           VkBufferCopy region{srcOffset, dstOffset, size};
-            vkCmdCopyBuffer(commandBuffer, src._, dst._, 1, &region);
-        });
+    UploadToken VulkanGraphicsService::copy(const Buffer &src, const Buffer &dst, VkDeviceSize size, VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
+        VkBufferCopy region{srcOffset, dstOffset, size};
+        m_uploads.copy(src._, dst._, { &region, 1 });
+        return m_uploads.open();
     }
 
     std::vector<VkDescriptorSet> VulkanGraphicsService::allocate(VkDescriptorPool pool, VkDescriptorSetLayout layout, uint32_t numSets) {
@@ -311,51 +578,51 @@ namespace vr {
     }
 
     void VulkanGraphicsService::shutdown() {
-        for(auto shader : m_shaders){
-            vkDestroyShaderModule(m_device, shader, nullptr);
-        }
-        for(auto pipeline : m_pipelines){
-            vkDestroyPipeline(m_device, pipeline, nullptr);
-        }
-        for(auto layout : m_pipelineLayouts) {
-            vkDestroyPipelineLayout(m_device, layout, nullptr);
-        }
-
-        for(auto setLayout : m_descriptorSetLayouts) {
-            vkDestroyDescriptorSetLayout(m_device, setLayout, nullptr);
-        }
-        for(auto pool : m_descriptorPools) {
-            vkDestroyDescriptorPool(m_device, pool, nullptr);
-        }
-
-        for(auto frameBuffer : m_frameBuffers) {
-            vkDestroyFramebuffer(m_device, frameBuffer, nullptr);
+        m_uploads.shutdown();
+        vkDeviceWaitIdle(m_device);
+        reclaim(true);
+        m_links.stats().log("shutdown");
+        m_pipelineCache.save();
+        m_pipelineCache.destroy();
+        for(auto& frameContext : m_frameContexts) {
+            vkDestroyFence(m_device, frameContext.fence, nullptr);
+            vkDestroyCommandPool(m_device, frameContext.commandPool, nullptr);
         }
 
-        for(auto renderPass : m_renderPasses) {
-            vkDestroyRenderPass(m_device, renderPass, nullptr);
-        }
+        const auto live = liveResources();
+        spdlog::debug("releasing {} buffers, {} images, {} image views, {} pipelines, {} frame buffers and {} other objects at shutdown"
+                      , live.buffers, live.images, live.imageViews, live.pipelines, live.frameBuffers
+                      , live.shaderModules + live.pipelineLayouts + live.descriptorSetLayouts + live.descriptorPools
+                        + live.renderPasses + live.commandPools);
 
+        auto destroyAll = [this]<typename T>(std::type_identity<T>) {
+            for(auto object : resources<T>()) {
+                destroy(object);
+            }
+            resources<T>().clear();
+        };
+        destroyAll(std::type_identity<VkShaderModule>{});
+        destroyAll(std::type_identity<VkPipeline>{});
+        destroyAll(std::type_identity<VkPipelineLayout>{});
+        destroyAll(std::type_identity<VkDescriptorSetLayout>{});
+        destroyAll(std::type_identity<VkDescriptorPool>{});
+        destroyAll(std::type_identity<VkFramebuffer>{});
+        destroyAll(std::type_identity<VkRenderPass>{});
+
+        vkDestroyFence(m_device, m_scopedFence, nullptr);
         vkDestroyCommandPool(m_device, m_commandPool, nullptr);
-        vkDestroyCommandPool(m_device, m_scopedCommandPool, nullptr);
-        for(auto commandPool : m_commandPools) {
-            vkDestroyCommandPool(m_device, commandPool, nullptr);
-        }
-
-        for(auto& mapping : m_mappings) {
-            mapping.unmap();
-        }
+        destroyAll(std::type_identity<VkCommandPool>{});
 
-        for(const auto& buffer : m_buffers) {
-            allocator.deallocate(buffer);
+        for(auto& tracked : m_buffers) {
+            destroy(tracked);
         }
+        m_buffers.clear();
 
-        for(auto view : m_imageViews){
-            vkDestroyImageView(m_device, view, nullptr);
-        }
+        destroyAll(std::type_identity<VkImageView>{});
         for(const auto& image : m_images) {
-            allocator.deallocate(image);
+            destroy(image);
         }
+        m_images.clear();
 
         allocator.destroy();
         vkDestroyDevice(m_device, nullptr);
@@ -382,45 +649,44 @@ namespace vr {
         return commandBuffers;
     }
 
-    VkPipelineLayout VulkanGraphicsService::createPipelineLayout(const VkPipelineLayoutCreateInfo &createInfo) {
+    Resource<VkPipelineLayout> VulkanGraphicsService::createPipelineLayout(const VkPipelineLayoutCreateInfo &createInfo) {
         VkPipelineLayout layout;
         CHECK_VULKAN(vkCreatePipelineLayout(m_device, &createInfo, nullptr, &layout));
-        m_pipelineLayouts.push_back(layout);
-        return layout;
+        return track(layout);
     }
 
-    VkPipeline VulkanGraphicsService::createGraphicsPipeline(const VkGraphicsPipelineCreateInfo &createInfo) {
+    Resource<VkPipeline> VulkanGraphicsService::createGraphicsPipeline(const VkGraphicsPipelineCreateInfo &createInfo) {
         VkPipeline pipeline;
-        CHECK_VULKAN(vkCreateGraphicsPipelines(m_device, nullptr, 1, &createInfo, nullptr, &pipeline));
-        m_pipelines.push_back(pipeline);
-        return pipeline;
+        const auto start = PipelineCacheStats::Clock::now();
+        CHECK_VULKAN(vkCreateGraphicsPipelines(m_device, m_pipelineCache, 1, &createInfo, nullptr, &pipeline));
+        m_pipelineCache.created(PipelineCacheStats::Clock::now() - start);
+        return track(pipeline);
     }
 
-    VkRenderPass VulkanGraphicsService::createRenderPass(const VkRenderPassCreateInfo &createInfo) {
+    Resource<VkRenderPass> VulkanGraphicsService::createRenderPass(const VkRenderPassCreateInfo &createInfo) {
         VkRenderPass renderPass;
         CHECK_VULKAN(vkCreateRenderPass(m_device, &createInfo, nullptr, &renderPass));
-        m_renderPasses.push_back(renderPass);
-        return renderPass;
+        return track(renderPass);
     }
 
-    std::vector<VkFramebuffer>
+    std::vector<Resource<VkFramebuffer>>
     VulkanGraphicsService::createFrameBuffers(const std::vector<VkFramebufferCreateInfo> &createInfos) {
-        const auto size = createInfos.size();
-        std::vector<VkFramebuffer> frameBuffers(size);
-        for(auto i = 0u; i < size; ++i){
-            CHECK_VULKAN(vkCreateFramebuffer(m_device, &createInfos[i], nullptr, &frameBuffers[i]));
-            m_frameBuffers.push_back(frameBuffers[i]);
+        std::vector<Resource<VkFramebuffer>> frameBuffers;
+        frameBuffers.reserve(createInfos.size());
+        for(const auto& createInfo : createInfos){
+            frameBuffers.push_back(createFrameBuffer(createInfo));
         }
         return frameBuffers;
     }
 
     Image VulkanGraphicsService::creatImage(const VkImageCreateInfo &createInfo) {
         auto image = allocator.allocate(createInfo);
-        m_images.push_back(image);
+        image.id = m_images.insert(image);
+        m_images[image.id].id = image.id;
         return image;
     }
 
-    VkShaderModule VulkanGraphicsService::createShaderModule(const std::filesystem::path &path) {
+    Resource<VkShaderModule> VulkanGraphicsService::createShaderModule(const std::filesystem::path &path) {
         io::FileReader fileReader{path};
         auto code = fileReader.readFully<uint32_t>();
 
@@ -430,20 +696,77 @@ namespace vr {
 
         VkShaderModule shaderModule;
         CHECK_VULKAN(vkCreateShaderModule(m_device, &createInfo, nullptr, &shaderModule));
-        m_shaders.push_back(shaderModule);
-        return shaderModule;
+        return track(shaderModule);
     }
 
     void VulkanGraphicsService::submitToGraphicsQueue(const VkSubmitInfo &submitInfo) {
+        // called from renderers while the frame's heap guard is armed, late latching and submission call into the runtime and driver
+        util::HeapGuardPause driver;
+        latch();
+        m_frameRing.flush();
+
+        // completion is tracked by the frame slot's fence, see endFrame
         CHECK_VULKAN(vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, nullptr));
-        vkQueueWaitIdle(m_graphicsQueue);
     }
 
-    VkFramebuffer VulkanGraphicsService::createFrameBuffer(const VkFramebufferCreateInfo &createInfo) {
+    void VulkanGraphicsService::submitToComputeQueue(const VkSubmitInfo &submitInfo, VkFence fence) {
+        CHECK_VULKAN(vkQueueSubmit(m_computeQueue._, 1, &submitInfo, fence));
+    }
+
+    VkCommandBuffer VulkanGraphicsService::beginScoped() {
+        if(!m_scopedCommandBuffer) {
+            auto allocateInfo = makeStruct<VkCommandBufferAllocateInfo>();
+            allocateInfo.commandPool = m_commandPool;
+            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+            allocateInfo.commandBufferCount = 1;
+            CHECK_VULKAN(vkAllocateCommandBuffers(m_device, &allocateInfo, &m_scopedCommandBuffer));
+        }
+
+        auto beginInfo = makeStruct<VkCommandBufferBeginInfo>();
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        CHECK_VULKAN(vkBeginCommandBuffer(m_scopedCommandBuffer, &beginInfo));
+        return m_scopedCommandBuffer;
+    }
+
+    void VulkanGraphicsService::endScoped(VkCommandBuffer commandBuffer, const std::vector<WaitSemaphore> &waits
+                                          , const std::vector<VkSemaphore> &signals) {
+        CHECK_VULKAN(vkEndCommandBuffer(commandBuffer));
+
+        std::vector<VkSemaphore> waitSemaphores;
+        std::vector<VkPipelineStageFlags> waitStages;
+        std::vector<uint64_t> waitValues;
+        for(auto semaphore : waits) {
+            waitSemaphores.push_back(semaphore._);
+            waitStages.push_back(semaphore.stage);
+            waitValues.push_back(semaphore.value);
+        }
+        std::vector<uint64_t> signalValues(signals.size(), 0);
+
+        auto timelineInfo = makeStruct<VkTimelineSemaphoreSubmitInfo>();
+        timelineInfo.waitSemaphoreValueCount = waitValues.size();
+        timelineInfo.pWaitSemaphoreValues = waitValues.data();
+        timelineInfo.signalSemaphoreValueCount = signalValues.size();
+        timelineInfo.pSignalSemaphoreValues = signalValues.data();
+
+        auto submitInfo = makeStruct<VkSubmitInfo>();
+        submitInfo.pNext = &timelineInfo;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.waitSemaphoreCount = waitSemaphores.size();
+        submitInfo.pWaitSemaphores = waitSemaphores.data();
+        submitInfo.pWaitDstStageMask = waitStages.data();
+        submitInfo.signalSemaphoreCount = signals.size();
+        submitInfo.pSignalSemaphores = signals.data();
+
+        CHECK_VULKAN(vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, m_scopedFence));
+        CHECK_VULKAN(vkWaitForFences(m_device, 1, &m_scopedFence, VK_TRUE, UINT64_MAX));
+        CHECK_VULKAN(vkResetFences(m_device, 1, &m_scopedFence));
+    }
+
+    Resource<VkFramebuffer> VulkanGraphicsService::createFrameBuffer(const VkFramebufferCreateInfo &createInfo) {
         VkFramebuffer framebuffer;
         CHECK_VULKAN(vkCreateFramebuffer(m_device, &createInfo, nullptr, &framebuffer));
-        m_frameBuffers.push_back(framebuffer);
-        return framebuffer;
+        return track(framebuffer);
     }
 
     glm::mat4 VulkanGraphicsService::projection(const XrFovf &fov, float zNear, float zFar) {
@@ -492,7 +815,11 @@ namespace vr {
         uint32_t imageIndex;
         vkAcquireNextImageKHR(m_device, m_mirrorSwapChain.swapchain, UINT64_MAX, m_transferStart, VK_NULL_HANDLE, &imageIndex);
 
-        scoped([&](auto commandBuffer) {
+        auto commandBuffer = frameCommandBuffers(1).front();
+        auto beginInfo = makeStruct<VkCommandBufferBeginInfo>();
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(commandBuffer, &beginInfo);
+        {
             auto srcImage = xrSwapchain.images[imageId.imageIndex].image;
             auto dstImage = m_mirrorSwapChain.images[imageIndex];
 
@@ -556,8 +883,19 @@ namespace vr {
             vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
                                  VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, 0,
                                  nullptr, 0, nullptr, 2, barriers.data());
-            
-        }, { {m_transferStart, VK_PIPELINE_STAGE_TRANSFER_BIT}}, { m_transferComplete });
+        }
+        vkEndCommandBuffer(commandBuffer);
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        auto submitInfo = makeStruct<VkSubmitInfo>();
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &m_transferStart;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.commandBufferCount = 1;
+        submitInfo.pCommandBuffers = &commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &m_transferComplete;
+        submitToGraphicsQueue(submitInfo);
 
         m_mirrorSwapChain.present(imageIndex, { m_transferComplete });
     }
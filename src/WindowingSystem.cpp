@@ -48,4 +48,8 @@ namespace vr {
     void WindowingSystem::pollEvents() {
         glfwPollEvents();
     }
+
+    void WindowingSystem::waitEvents(std::chrono::duration<double> timeout) {
+        glfwWaitEventsTimeout(timeout.count());
+    }
 }
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <algorithm>
+#include <cinttypes>
+
+namespace util {
+
+    // cpu time consumed by the calling thread
+    std::chrono::nanoseconds threadCpuTime();
+
+    /**
+     * Idle time, the cpu time burnt while idle and how long it took to notice activity after going idle,
+     * wake latency is measured as the length of the wait that preceded the activity so it is an upper bound
+     */
+    struct IdleStats {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t periods{};
+        uint64_t waits{};
+        Clock::duration idle{};
+        std::chrono::nanoseconds cpu{};
+        Clock::duration wakeLatency{};
+        Clock::duration maxWakeLatency{};
+        uint64_t wakes{};
+        Clock::time_point lastReport{Clock::now()};
+
+        void wake(Clock::duration latency) {
+            ++wakes;
+            wakeLatency += latency;
+            maxWakeLatency = std::max(maxWakeLatency, latency);
+        }
+
+        // logs and resets the accumulated stats at most once per interval
+        void report(std::chrono::seconds interval = std::chrono::seconds{5});
+    };
+
+    /**
+     * Wait strategy for loop iterations that have no frame work, the wait starts short and doubles
+     * every iteration without activity up to a maximum, any activity drops it back to the minimum
+     * since events tend to arrive in bursts (e.g. IDLE followed by READY). The maximum bounds how late
+     * the first event of a burst is seen, keep it well under a frame so READY is not delayed
+     */
+    class AdaptiveIdle {
+    public:
+        using Clock = IdleStats::Clock;
+
+        explicit AdaptiveIdle(Clock::duration minWait = std::chrono::milliseconds{1}
+                              , Clock::duration maxWait = std::chrono::milliseconds{10})
+        : m_minWait{minWait}
+        , m_maxWait{maxWait}
+        , m_wait{minWait}
+        {}
+
+        /**
+         * call once per idle loop iteration, wait should block for at most the duration it is given
+         * and may return early if it can tell that there is work to do
+         */
+        template<typename Wait>
+        void idle(bool activity, Wait&& wait) {
+            if(activity) {
+                if(m_idling) {
+                    m_stats.wake(m_lastWait);
+                }
+                reset();
+                return;
+            }
+
+            if(!m_idling) {
+                m_idling = true;
+                m_idleStart = Clock::now();
+                m_cpuStart = threadCpuTime();
+            }
+
+            const auto waitStart = Clock::now();
+            wait(m_wait);
+            m_lastWait = Clock::now() - waitStart;
+            ++m_stats.waits;
+            m_wait = std::min(m_wait * 2, m_maxWait);
+
+            m_stats.report();
+        }
+
+        // ends the current idle period, e.g. when the frame loop takes over
+        void reset() {
+            if(m_idling) {
+                ++m_stats.periods;
+                m_stats.idle += Clock::now() - m_idleStart;
+                m_stats.cpu += threadCpuTime() - m_cpuStart;
+                m_idling = false;
+            }
+            m_wait = m_minWait;
+        }
+
+        [[nodiscard]]
+        const IdleStats& stats() const {
+            return m_stats;
+        }
+
+    private:
+        Clock::duration m_minWait;
+        Clock::duration m_maxWait;
+        Clock::duration m_wait;
+        Clock::duration m_lastWait{};
+        bool m_idling{false};
+        Clock::time_point m_idleStart{};
+        std::chrono::nanoseconds m_cpuStart{};
+        IdleStats m_stats;
+    };
+}
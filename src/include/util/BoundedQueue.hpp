@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <cstddef>
+
+namespace util {
+
+    template<typename T, std::size_t Capacity>
+    class BoundedQueue {
+    public:
+        static_assert(Capacity > 0, "queue capacity must be greater than zero");
+
+        // blocks while the queue is full, returns false if the queue was closed
+        bool push(const T& item) {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_notFull.wait(lock, [this]{ return m_closed || m_size < Capacity; });
+            if(m_closed) {
+                return false;
+            }
+            m_items[(m_head + m_size) % Capacity] = item;
+            ++m_size;
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        // returns false without blocking if the queue is full or closed
+        bool tryPush(const T& item) {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            if(m_closed || m_size == Capacity) {
+                return false;
+            }
+            m_items[(m_head + m_size) % Capacity] = item;
+            ++m_size;
+            m_notEmpty.notify_one();
+            return true;
+        }
+
+        // blocks while the queue is empty, returns nothing once closed and drained
+        std::optional<T> pop() {
+            std::unique_lock<std::mutex> lock{m_mutex};
+            m_notEmpty.wait(lock, [this]{ return m_closed || m_size > 0; });
+            return take();
+        }
+
+        std::optional<T> tryPop() {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            return take();
+        }
+
+        void close() {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_closed = true;
+            m_notEmpty.notify_all();
+            m_notFull.notify_all();
+        }
+
+        void reopen() {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_closed = false;
+            m_head = 0;
+            m_size = 0;
+        }
+
+    private:
+        std::optional<T> take() {
+            if(m_size == 0) {
+                return {};
+            }
+            T item = m_items[m_head];
+            m_head = (m_head + 1) % Capacity;
+            --m_size;
+            m_notFull.notify_one();
+            return item;
+        }
+
+    private:
+        std::array<T, Capacity> m_items{};
+        std::size_t m_head{};
+        std::size_t m_size{};
+        bool m_closed{false};
+        std::mutex m_mutex;
+        std::condition_variable m_notEmpty;
+        std::condition_variable m_notFull;
+    };
+}
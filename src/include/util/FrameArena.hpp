@@ -0,0 +1,82 @@
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <memory_resource>
+#include <memory>
+#include <optional>
+#include <cstddef>
+#include <algorithm>
+
+namespace util {
+
+    /**
+     * Linear allocator for data that only lives for one frame, allocations bump a pointer
+     * through a preallocated buffer and are all released at once by reset.
+     * Allocations that do not fit spill over to the upstream resource, reset then grows the
+     * buffer so the next frame fits again
+     */
+    class FrameArena : public std::pmr::memory_resource {
+    public:
+        explicit FrameArena(std::size_t capacity = 64 * 1024)
+        : m_capacity{capacity}
+        , m_buffer{std::make_unique<std::byte[]>(capacity)}
+        {
+            m_resource.emplace(m_buffer.get(), m_capacity, std::pmr::new_delete_resource());
+        }
+
+        FrameArena(const FrameArena&) = delete;
+
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        void reset() {
+            m_highWater = std::max(m_highWater, m_used);
+            m_resource->release();
+
+            if(m_used > m_capacity) {
+                const auto capacity = std::max(m_used, m_capacity * 2);
+                spdlog::warn("frame arena overflowed, {} bytes used of {}, growing to {} bytes", m_used, m_capacity, capacity);
+                m_resource.reset();
+                m_buffer = std::make_unique<std::byte[]>(capacity);
+                m_capacity = capacity;
+                m_resource.emplace(m_buffer.get(), m_capacity, std::pmr::new_delete_resource());
+            }
+            m_used = 0;
+        }
+
+        [[nodiscard]]
+        std::size_t used() const {
+            return m_used;
+        }
+
+        [[nodiscard]]
+        std::size_t highWater() const {
+            return std::max(m_highWater, m_used);
+        }
+
+        [[nodiscard]]
+        std::size_t capacity() const {
+            return m_capacity;
+        }
+
+    protected:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            m_used += bytes;
+            return m_resource->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+        [[nodiscard]]
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        std::size_t m_capacity{};
+        std::size_t m_used{};
+        std::size_t m_highWater{};
+        std::unique_ptr<std::byte[]> m_buffer;
+        std::optional<std::pmr::monotonic_buffer_resource> m_resource;
+    };
+}
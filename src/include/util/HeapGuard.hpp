@@ -0,0 +1,70 @@
+#pragma once
+
+namespace util {
+
+    /**
+     * Debug check that fails the run when a thread allocates from the global heap while armed.
+     * Only active in builds configured with VR_HEAP_GUARD, otherwise arming is a no-op
+     */
+    struct HeapGuard {
+#ifdef VR_HEAP_GUARD
+        static constexpr bool enabled = true;
+
+        static void arm();
+
+        static void disarm();
+
+        static bool armed();
+#else
+        static constexpr bool enabled = false;
+
+        static void arm() {}
+
+        static void disarm() {}
+
+        static bool armed() { return false; }
+#endif
+    };
+
+    // arms the guard on the calling thread for the lifetime of the scope
+    class HeapGuardScope {
+    public:
+        explicit HeapGuardScope(bool arm) : m_armed{arm} {
+            if(m_armed) HeapGuard::arm();
+        }
+
+        ~HeapGuardScope() {
+            if(m_armed) HeapGuard::disarm();
+        }
+
+        HeapGuardScope(const HeapGuardScope&) = delete;
+
+        HeapGuardScope& operator=(const HeapGuardScope&) = delete;
+
+    private:
+        bool m_armed;
+    };
+
+    /**
+     * disarms the guard for the lifetime of the scope if it is armed, for calls into the XR runtime
+     * or graphics driver, their allocations go through the replaced global operator new on some
+     * platforms and are not the application's to avoid
+     */
+    class HeapGuardPause {
+    public:
+        HeapGuardPause() : m_wasArmed{HeapGuard::armed()} {
+            if(m_wasArmed) HeapGuard::disarm();
+        }
+
+        ~HeapGuardPause() {
+            if(m_wasArmed) HeapGuard::arm();
+        }
+
+        HeapGuardPause(const HeapGuardPause&) = delete;
+
+        HeapGuardPause& operator=(const HeapGuardPause&) = delete;
+
+    private:
+        bool m_wasArmed;
+    };
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <cstddef>
+
+namespace util {
+
+    /**
+     * Read only memory mapping of a whole file, the mapping is released on destruction
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+
+        explicit MappedFile(const std::filesystem::path& path);
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        MappedFile(MappedFile&& source) noexcept;
+
+        MappedFile& operator=(MappedFile&& source) noexcept;
+
+        ~MappedFile();
+
+        [[nodiscard]]
+        std::span<const std::byte> data() const {
+            return { m_data, m_size };
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return m_size;
+        }
+
+        [[nodiscard]]
+        bool isOpen() const {
+            return m_data != nullptr;
+        }
+
+    private:
+        void close();
+
+    private:
+        const std::byte* m_data{};
+        size_t m_size{};
+#ifdef _WIN32
+        void* m_file{};
+        void* m_mapping{};
+#endif
+    };
+}
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <vector>
+#include <span>
+#include <optional>
+#include <utility>
+#include <cassert>
+#include <cinttypes>
+
+namespace util {
+
+    /**
+     * Reference to an element of a SlotMap. Handles of released elements go stale, they are told
+     * apart from the handle of whatever reuses the slot by its generation
+     */
+    template<typename Tag>
+    struct Handle {
+        static constexpr uint32_t InvalidIndex{~0u};
+
+        uint32_t index{InvalidIndex};
+        uint32_t generation{};
+
+        [[nodiscard]]
+        bool valid() const {
+            return index != InvalidIndex;
+        }
+
+        bool operator==(const Handle&) const = default;
+    };
+
+    /**
+     * Generational slot map with O(1) insert, lookup and erase. Values are packed densely, so
+     * iterating over the live ones skips no holes, slots translate handles to dense indices and
+     * are recycled through a free list. Erasing bumps the slot's generation which invalidates
+     * every handle to the erased value
+     */
+    template<typename T, typename Tag = T>
+    class SlotMap {
+    public:
+        using Handle = util::Handle<Tag>;
+
+        void reserve(size_t capacity) {
+            m_values.reserve(capacity);
+            m_owners.reserve(capacity);
+            m_slots.reserve(capacity);
+        }
+
+        Handle insert(T value) {
+            uint32_t index;
+            if(m_freeList != Handle::InvalidIndex) {
+                index = m_freeList;
+                m_freeList = m_slots[index].next;
+            }else {
+                index = static_cast<uint32_t>(m_slots.size());
+                m_slots.emplace_back();
+            }
+
+            auto& slot = m_slots[index];
+            slot.dense = static_cast<uint32_t>(m_values.size());
+            m_values.push_back(std::move(value));
+            m_owners.push_back(index);
+            return { index, slot.generation };
+        }
+
+        [[nodiscard]]
+        bool contains(Handle handle) const {
+            return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+        }
+
+        [[nodiscard]]
+        T* find(Handle handle) {
+            return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+        }
+
+        [[nodiscard]]
+        const T* find(Handle handle) const {
+            return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+        }
+
+        T& operator[](Handle handle) {
+            assert(contains(handle));
+            return m_values[m_slots[handle.index].dense];
+        }
+
+        const T& operator[](Handle handle) const {
+            assert(contains(handle));
+            return m_values[m_slots[handle.index].dense];
+        }
+
+        // the erased value, for the caller to destroy what it owns, nothing if the handle was stale
+        std::optional<T> erase(Handle handle) {
+            if(!contains(handle)) return {};
+
+            auto& slot = m_slots[handle.index];
+            const auto dense = slot.dense;
+            std::optional<T> value{ std::move(m_values[dense]) };
+
+            // the last value fills the hole
+            const auto last = static_cast<uint32_t>(m_values.size() - 1);
+            if(dense != last) {
+                m_values[dense] = std::move(m_values[last]);
+                m_owners[dense] = m_owners[last];
+                m_slots[m_owners[dense]].dense = dense;
+            }
+            m_values.pop_back();
+            m_owners.pop_back();
+
+            ++slot.generation;
+            slot.next = m_freeList;
+            m_freeList = handle.index;
+            return value;
+        }
+
+        void clear() {
+            for(auto index : m_owners) {
+                auto& slot = m_slots[index];
+                ++slot.generation;
+                slot.next = m_freeList;
+                m_freeList = index;
+            }
+            m_values.clear();
+            m_owners.clear();
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return m_values.size();
+        }
+
+        [[nodiscard]]
+        bool empty() const {
+            return m_values.empty();
+        }
+
+        // live values in no particular order
+        [[nodiscard]]
+        std::span<T> values() {
+            return m_values;
+        }
+
+        [[nodiscard]]
+        std::span<const T> values() const {
+            return m_values;
+        }
+
+        auto begin() { return m_values.begin(); }
+        auto end() { return m_values.end(); }
+        auto begin() const { return m_values.begin(); }
+        auto end() const { return m_values.end(); }
+
+    private:
+        struct Slot {
+            uint32_t dense{};
+            uint32_t next{Handle::InvalidIndex};
+            uint32_t generation{};
+        };
+
+        std::vector<T> m_values;
+        std::vector<uint32_t> m_owners;     // slot of each dense value
+        std::vector<Slot> m_slots;
+        uint32_t m_freeList{Handle::InvalidIndex};
+    };
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <optional>
+#include <cstddef>
+
+namespace util {
+
+    inline constexpr std::size_t CacheLineSize{64};
+
+    /**
+     * Lock free ring for exactly one producer thread and one consumer thread. Each side keeps a
+     * cached copy of the other side's index and only reloads it when the ring looks full (or empty),
+     * so in the common case a push or pop touches no cache line owned by the other thread
+     */
+    template<typename T, std::size_t Capacity>
+    class SpscRing {
+    public:
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "ring capacity must be a power of two");
+
+        // producer only, returns false if the ring is full
+        bool tryPush(const T& item) {
+            const auto tail = m_tail.load(std::memory_order_relaxed);
+            if(tail - m_cachedHead == Capacity) {
+                m_cachedHead = m_head.load(std::memory_order_acquire);
+                if(tail - m_cachedHead == Capacity) {
+                    return false;
+                }
+            }
+            m_items[tail & Mask] = item;
+            m_tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer only
+        std::optional<T> tryPop() {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            if(head == m_cachedTail) {
+                m_cachedTail = m_tail.load(std::memory_order_acquire);
+                if(head == m_cachedTail) {
+                    return {};
+                }
+            }
+            T item = m_items[head & Mask];
+            m_head.store(head + 1, std::memory_order_release);
+            return item;
+        }
+
+        // consumer only, pops every item currently in the ring
+        template<typename Consumer>
+        std::size_t drain(Consumer&& consumer) {
+            const auto head = m_head.load(std::memory_order_relaxed);
+            m_cachedTail = m_tail.load(std::memory_order_acquire);
+            for(auto i = head; i != m_cachedTail; ++i) {
+                consumer(m_items[i & Mask]);
+            }
+            m_head.store(m_cachedTail, std::memory_order_release);
+            return m_cachedTail - head;
+        }
+
+        // only exact when called from a side that is not running concurrently
+        [[nodiscard]]
+        std::size_t size() const {
+            return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]]
+        static constexpr std::size_t capacity() {
+            return Capacity;
+        }
+
+    private:
+        static constexpr std::size_t Mask{Capacity - 1};
+
+        alignas(CacheLineSize) std::atomic<std::size_t> m_head{};
+        std::size_t m_cachedTail{};     // consumer's view of m_tail
+        alignas(CacheLineSize) std::atomic<std::size_t> m_tail{};
+        std::size_t m_cachedHead{};     // producer's view of m_head
+        alignas(CacheLineSize) std::array<T, Capacity> m_items{};
+    };
+}
@@ -6,13 +6,38 @@
 #include <glm/glm.hpp>
 
 #include <string>
+#include <string_view>
 #include <variant>
 #include <map>
+#include <memory_resource>
+#include <stdexcept>
+#include <vector>
+#include <limits>
+#include <cassert>
+#include <cinttypes>
 
 namespace vr {
 
     using ActionState = std::variant<bool, float, glm::vec2, Pose>;
 
+    // index of an action within its action set, assigned when the session sets up its actions
+    using ActionId = uint32_t;
+    using ActionSetId = uint32_t;
+
+    static constexpr ActionId InvalidActionId{ std::numeric_limits<ActionId>::max() };
+    static constexpr ActionSetId InvalidActionSetId{ std::numeric_limits<ActionSetId>::max() };
+
+    /**
+     * Typed, constant index of an action, created from an ActionTable so a misspelt name
+     * or a mismatched value type fails to compile
+     */
+    template<typename T>
+    struct ActionHandle {
+        using value_type = T;
+
+        ActionId id{InvalidActionId};
+    };
+
     struct Action {
         std::string name;
         bool changed{};
@@ -29,9 +54,61 @@ namespace vr {
         }
     };
 
+    /**
+     * Action states stored contiguously and indexed by ActionId, names are only
+     * resolved to ids while setting up, per frame access goes through the id
+     */
     struct ActionSet {
         std::string name;
-        std::map<std::string, Action> actions;
+        ActionSetId id{};
+        std::vector<Action> actions;
+        std::map<std::string, ActionId, std::less<>> ids;
+
+        // initial holds the action's value type, typed access relies on the state never changing type
+        ActionId add(std::string_view name, ActionState initial = {}) {
+            const auto id = static_cast<ActionId>(actions.size());
+            actions.push_back({ std::string{name}, false, false, initial });
+            ids.emplace(name, id);
+            return id;
+        }
+
+        [[nodiscard]]
+        ActionId id(std::string_view name) const {
+            auto itr = ids.find(name);
+            if(itr == ids.end()) {
+                throw std::out_of_range{std::string{name} + " is not an action of " + this->name};
+            }
+            return itr->second;
+        }
+
+        [[nodiscard]]
+        const Action& operator[](ActionId actionId) const {
+            return actions[actionId];
+        }
+
+        [[nodiscard]]
+        Action& operator[](ActionId actionId) {
+            return actions[actionId];
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        const Action& operator[](ActionHandle<T> handle) const {
+            return actions[handle.id];
+        }
+
+        // the handle's type is checked against the action when the table is declared, so release builds don't check the state again
+        template<typename T>
+        [[nodiscard]]
+        const T& value(ActionHandle<T> handle) const {
+            assert(std::holds_alternative<T>(actions[handle.id]._value));
+            return *std::get_if<T>(&actions[handle.id]._value);
+        }
+
+        [[nodiscard]]
+        const Action& get(std::string_view name) const {
+            return actions[id(name)];
+        }
 
         auto begin() {
             return actions.begin();
@@ -52,15 +129,17 @@ namespace vr {
         }
 
         [[nodiscard]]
-        const Action& get(const std::string& name) const {
-            return actions.at(name);
+        size_t size() const {
+            return actions.size();
         }
     };
 
     struct Vibrate {
-        std::string action;
+        ActionId action{InvalidActionId};
         XrDuration duration{XR_MIN_HAPTIC_DURATION};
         float frequency{XR_FREQUENCY_UNSPECIFIED};
         float amplitude{0.5};
     };
+
+    using Vibrations = std::pmr::vector<Vibrate>;
 }
\ No newline at end of file
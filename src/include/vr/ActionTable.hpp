@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Action.hpp"
+#include "Input.hpp"
+#include "specification/ActionSetSpecification.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <string_view>
+#include <algorithm>
+#include <stdexcept>
+#include <cstddef>
+
+namespace vr {
+
+    // value type of vibration actions, they have no state to read
+    struct Haptic {};
+
+    template<Component component>
+    struct ComponentTraits;
+
+    template<> struct ComponentTraits<Component::CLICK> { using type = bool; };
+    template<> struct ComponentTraits<Component::TOUCH> { using type = bool; };
+    template<> struct ComponentTraits<Component::FORCE> { using type = float; };
+    template<> struct ComponentTraits<Component::VALUE> { using type = float; };
+    template<> struct ComponentTraits<Component::TWIST> { using type = float; };
+    template<> struct ComponentTraits<Component::X> { using type = glm::vec2; };
+    template<> struct ComponentTraits<Component::Y> { using type = glm::vec2; };
+    template<> struct ComponentTraits<Component::POSE> { using type = Pose; };
+    template<> struct ComponentTraits<Component::VIBRATE> { using type = Haptic; };
+
+    template<Component component>
+    using ComponentType = typename ComponentTraits<component>::type;
+
+    struct ActionDeclaration {
+        std::string_view name;
+        Source source;
+        Identifier identifier;
+        Component component;
+        std::string_view description{};
+    };
+
+    /**
+     * Action set declared at compile time, an action's id is the rank of its name among the table's
+     * names, which is the order the session assigns ids in (ActionSetSpecification keeps its actions
+     * sorted by name). Declare tables as inline constexpr variables and get handles with vr::action
+     *
+     *  inline constexpr vr::ActionTable Actions{ "main", "main actions", {
+     *      {"a", vr::Source::RIGHT_HAND, vr::Identifier::A, vr::Component::CLICK}
+     *  }};
+     *  inline constexpr auto AButton = vr::action<Actions, "a">;    // ActionHandle<bool>
+     */
+    template<size_t N>
+    struct ActionTable {
+        std::string_view name;
+        std::string_view description;
+        std::array<ActionDeclaration, N> actions;
+
+        consteval ActionTable(std::string_view aName, std::string_view aDescription, const ActionDeclaration (&declarations)[N])
+        : name{aName}
+        , description{aDescription}
+        , actions{}
+        {
+            if(name.empty()) {
+                throw std::invalid_argument{"action set name is required"};
+            }
+            for(auto i = 0u; i < N; ++i) {
+                if(declarations[i].name.empty()) {
+                    throw std::invalid_argument{"action name is required"};
+                }
+                for(auto j = 0u; j < i; ++j) {
+                    if(declarations[i].name == declarations[j].name) {
+                        throw std::invalid_argument{"action names must be unique"};
+                    }
+                }
+                actions[i] = declarations[i];
+            }
+        }
+
+        [[nodiscard]]
+        constexpr size_t indexOf(std::string_view actionName) const {
+            for(auto i = 0u; i < N; ++i) {
+                if(actions[i].name == actionName) return i;
+            }
+            throw std::out_of_range{"action is not declared in the table"};
+        }
+
+        [[nodiscard]]
+        constexpr ActionId id(std::string_view actionName) const {
+            const auto index = indexOf(actionName);
+            return static_cast<ActionId>(std::count_if(actions.begin(), actions.end(), [&](const auto& action){
+                return action.name < actions[index].name;
+            }));
+        }
+
+        [[nodiscard]]
+        constexpr Component component(std::string_view actionName) const {
+            return actions[indexOf(actionName)].component;
+        }
+
+        [[nodiscard]]
+        ActionSetSpecification specification() const {
+            ActionSetSpecification spec{};
+            spec.name(name).description(description);
+            for(const auto& action : actions) {
+                spec.addAction(action.name, action.source, action.identifier, action.component, action.description);
+            }
+            return spec;
+        }
+
+        // checks the ids the session assigned against the table's, they only differ if the set was not created from it
+        void verify(const ActionSet& actionSet) const {
+            if(actionSet.name != name) {
+                THROW(std::format("action table {} verified against action set {}", name, actionSet.name));
+            }
+            for(const auto& action : actions) {
+                const auto itr = actionSet.ids.find(action.name);
+                if(itr == actionSet.ids.end() || itr->second != id(action.name)) {
+                    THROW(std::format("action {} of {} does not match its declaration", action.name, name));
+                }
+            }
+        }
+    };
+
+    template<size_t N>
+    struct FixedString {
+        char value[N]{};
+
+        constexpr FixedString(const char (&str)[N]) {
+            std::copy_n(str, N, value);
+        }
+
+        [[nodiscard]]
+        constexpr std::string_view view() const {
+            return { value, N - 1 };
+        }
+    };
+
+    template<const auto& Table, FixedString Name>
+    inline constexpr ActionHandle<ComponentType<Table.component(Name.view())>> action{ Table.id(Name.view()) };
+
+}
@@ -2,6 +2,7 @@
 
 #include "vr/graphics/Renderer.hpp"
 #include "util/ExponentialBackoff.hpp"
+#include "util/AdaptiveIdle.hpp"
 #include "SessionConfig.hpp"
 
 #include <memory>
@@ -24,14 +25,13 @@ namespace vr {
 
         void shutdown();
 
-        static bool pollEvents(const Context& context, XrEventDataBuffer& event);
-
     private:
         std::shared_ptr<Renderer> m_renderer;
         GraphicsFactory createGraphicsService;
         const ContextCreation& m_contextCreator;
         const SessionConfig& m_sessionConfig;
         util::Backoff backoff;
+        util::AdaptiveIdle m_idle;
 
     };
 }
\ No newline at end of file
@@ -24,6 +24,7 @@ namespace vr {
         XrSystemId systemId{XR_NULL_SYSTEM_ID};
         std::shared_ptr<GraphicsContext> graphicsContext;
         XrInstanceCreateInfo info{};
+        std::vector<std::string> extensions;
 #ifndef NDEBUG
 #ifdef XR_DEBUG
       XrDebugUtilsMessengerEXT debugMessenger{XR_NULL_HANDLE};
@@ -33,6 +34,9 @@ namespace vr {
       [[nodiscard]]
       bool isSupported(XrViewConfigurationType type) const;
 
+      [[nodiscard]]
+      bool isEnabled(std::string_view extension) const;
+
       [[nodiscard]]
       std::vector<XrViewConfigurationView> views(XrViewConfigurationType viewType) const;
 
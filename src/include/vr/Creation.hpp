@@ -105,6 +105,17 @@ namespace vr {
 #ifdef XR_DEBUG
         XR_EXT_DEBUG_UTILS_EXTENSION_NAME
 #endif
+#endif
+        };
+        std::vector<cstring> optionalExtensions{
+#ifdef XR_KHR_locate_spaces
+            XR_KHR_LOCATE_SPACES_EXTENSION_NAME,
+#endif
+            XR_EXT_HAND_TRACKING_EXTENSION_NAME,
+#ifdef _WIN32
+            "XR_KHR_win32_convert_performance_counter_time"
+#else
+            "XR_KHR_convert_timespec_time"
 #endif
         };
 
@@ -114,6 +125,13 @@ namespace vr {
             return *this;
         }
 
+        // enabled only when the runtime supports it, check with Context::isEnabled
+        [[maybe_unused]]
+        ContextCreation& addOptionalExtension(cstring  extension) {
+            optionalExtensions.push_back(extension);
+            return *this;
+        }
+
         ContextCreation& appName(cstring  name) {
             _appName = name;
             return *this;
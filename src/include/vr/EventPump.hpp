@@ -0,0 +1,76 @@
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <unordered_map>
+
+namespace vr {
+
+    /**
+     * Number of events handled per frame and the time spent handling them
+     */
+    struct EventStats {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t frames{};
+        uint64_t events{};
+        uint32_t maxEventsPerFrame{};
+        Clock::duration cost{};
+        Clock::duration maxCost{};
+        Clock::time_point lastReport{Clock::now()};
+
+        void record(uint32_t count, Clock::duration duration) {
+            ++frames;
+            events += count;
+            cost += duration;
+            maxEventsPerFrame = std::max(maxEventsPerFrame, count);
+            maxCost = std::max(maxCost, duration);
+        }
+
+        // logs and resets the accumulated stats at most once per interval
+        void report(std::chrono::seconds interval = std::chrono::seconds{5});
+    };
+
+    /**
+     * Drains the OpenXR event queue every frame and dispatches each event to the handler
+     * registered for its structure type, events without a handler are logged and dropped
+     */
+    class EventPump {
+    public:
+        using Handler = std::function<void(const XrEventDataBuffer&)>;
+
+        static constexpr uint32_t MaxEventsPerFrame{64};
+
+        explicit EventPump(XrInstance instance);
+
+        EventPump& on(XrStructureType type, Handler handler);
+
+        template<typename Event>
+        EventPump& on(XrStructureType type, std::function<void(const Event&)> handler) {
+            return on(type, [handler=std::move(handler)](const XrEventDataBuffer& event){
+                handler(reinterpret_cast<const Event&>(event));
+            });
+        }
+
+        // returns the number of events handled
+        uint32_t pump();
+
+        [[nodiscard]]
+        const EventStats& stats() const {
+            return m_stats;
+        }
+
+    private:
+        void unhandled(const XrEventDataBuffer& event);
+
+    private:
+        XrInstance m_instance{XR_NULL_HANDLE};
+        XrEventDataBuffer m_event{XR_TYPE_EVENT_DATA_BUFFER};
+        std::unordered_map<XrStructureType, Handler> m_handlers;
+        std::unordered_map<XrStructureType, uint64_t> m_unhandled;
+        EventStats m_stats;
+    };
+}
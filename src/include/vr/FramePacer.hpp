@@ -0,0 +1,75 @@
+#pragma once
+
+#include "util/BoundedQueue.hpp"
+
+#include <openxr/openxr.h>
+
+#include <chrono>
+#include <thread>
+#include <functional>
+#include <atomic>
+
+namespace vr {
+
+    /**
+     * Accumulates how long the frame thread waits for a frame versus how long it works on one,
+     * the difference between the predicted display period and the work is the cpu headroom
+     */
+    struct FramePacingStats {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t frames{};
+        Clock::duration wait{};
+        Clock::duration work{};
+        XrDuration displayPeriod{};
+        Clock::time_point lastReport{Clock::now()};
+
+        void record(Clock::duration waitTime, Clock::duration workTime, XrDuration period) {
+            ++frames;
+            wait += waitTime;
+            work += workTime;
+            displayPeriod += period;
+        }
+
+        // logs and resets the accumulated stats at most once per interval
+        void report(const char* mode, std::chrono::seconds interval = std::chrono::seconds{5});
+    };
+
+    /**
+     * Runs xrWaitFrame on a dedicated thread and hands the resulting frame state to the frame thread
+     * through a single slot queue, so frame N+1 can be recorded while frame N is still on the GPU
+     */
+    class FramePacer {
+    public:
+        using DiscardFrame = std::function<void(const XrFrameState&)>;
+
+        FramePacer() = default;
+
+        FramePacer(const FramePacer&) = delete;
+
+        FramePacer& operator=(const FramePacer&) = delete;
+
+        ~FramePacer();
+
+        void start(XrSession session);
+
+        // frames already waited on but not yet consumed are passed to discard so they can be begun and ended
+        void stop(const DiscardFrame& discard);
+
+        bool next(XrFrameState& frameState);
+
+        [[nodiscard]]
+        bool running() const {
+            return m_running;
+        }
+
+    private:
+        void run(std::stop_token stopToken);
+
+    private:
+        XrSession m_session{XR_NULL_HANDLE};
+        util::BoundedQueue<XrFrameState, 1> m_frames;
+        std::jthread m_thread;
+        std::atomic_bool m_running{false};
+    };
+}
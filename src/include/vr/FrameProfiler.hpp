@@ -0,0 +1,107 @@
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <string>
+#include <filesystem>
+#include <cinttypes>
+
+namespace vr {
+
+    using PhaseId = uint32_t;
+
+    struct PhaseSummary {
+        std::string name;
+        uint64_t samples{};
+        double p50{};
+        double p95{};
+        double p99{};
+        double max{};
+        double mean{};
+    };
+
+    /**
+     * Times the phases of the frame loop and keeps the last WindowSize frames of every phase,
+     * percentiles are only computed when a summary is requested so recording stays cheap
+     * enough to leave enabled. Time measured several times within a frame accumulates into
+     * one sample, frames that never enter a phase do not add a sample to it.
+     * All times are in milliseconds, the profiler is only used from the frame thread
+     */
+    class FrameProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32_t WindowSize{1024};
+
+        enum Phase : PhaseId {
+            Wait = 0, Begin, ActionSync, SpaceLocate, Acquire, RendererRecord, Submit, Release, End, Frame, BuiltInPhases
+        };
+
+        class Scope {
+        public:
+            Scope(FrameProfiler& profiler, PhaseId phase)
+            : m_profiler{&profiler}
+            , m_phase{phase}
+            , m_start{Clock::now()}
+            {}
+
+            Scope(const Scope&) = delete;
+
+            Scope& operator=(const Scope&) = delete;
+
+            ~Scope() {
+                m_profiler->record(m_phase, Clock::now() - m_start);
+            }
+
+        private:
+            FrameProfiler* m_profiler;
+            PhaseId m_phase;
+            Clock::time_point m_start;
+        };
+
+        FrameProfiler();
+
+        // registers a phase with the given name, or returns the existing one
+        PhaseId addPhase(std::string_view name);
+
+        [[nodiscard]]
+        Scope measure(PhaseId phase) {
+            return { *this, phase };
+        }
+
+        void record(PhaseId phase, Clock::duration duration) {
+            auto& series = m_series[phase];
+            series.current += std::chrono::duration<float, std::milli>(duration).count();
+            series.touched = true;
+        }
+
+        // commits the time accumulated by each phase during the frame
+        void nextFrame();
+
+        [[nodiscard]]
+        std::vector<PhaseSummary> summary() const;
+
+        // writes the summary as json if path has a .json extension, as csv otherwise
+        void write(const std::filesystem::path& path) const;
+
+        void log() const;
+
+        [[nodiscard]]
+        uint64_t frames() const {
+            return m_frames;
+        }
+
+    private:
+        struct Series {
+            std::string name;
+            std::vector<float> window;
+            uint32_t next{};
+            uint64_t samples{};
+            float current{};
+            bool touched{};
+        };
+
+        std::vector<Series> m_series;
+        uint64_t m_frames{};
+    };
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "Context.hpp"
+#include "Transforms.hpp"
+
+#include <openxr/openxr.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <array>
+#include <cinttypes>
+
+namespace vr {
+
+    enum class Handedness : uint32_t { Left = 0, Right, Count };
+
+    /**
+     * Runtime locates the joints with XR_EXT_hand_tracking, Synthetic stands in for a runtime
+     * by animating a pair of hands in front of the base space, for testing without hand tracking hardware
+     */
+    enum class HandTrackingMode { Off, Runtime, Synthetic };
+
+    /**
+     * Joints of one hand as structure of arrays indexed by XrHandJointEXT. positions and orientations
+     * are laid out to be copied as they are into a std430 buffer of vec4s, orientations as x, y, z, w
+     */
+    struct HandJoints {
+        static constexpr uint32_t Count{XR_HAND_JOINT_COUNT_EXT};
+
+        std::array<glm::vec4, Count> positions{};      // xyz in the base space, w the joint's radius
+        std::array<glm::quat, Count> orientations{};
+        std::array<XrSpaceLocationFlags, Count> flags{};
+        bool isActive{};
+
+        [[nodiscard]]
+        bool isLocated(uint32_t joint) const {
+            constexpr XrSpaceLocationFlags located = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+            return (flags[joint] & located) == located;
+        }
+
+        [[nodiscard]]
+        Pose pose(uint32_t joint) const {
+            return { orientations[joint], glm::vec3(positions[joint]) };
+        }
+
+        [[nodiscard]]
+        float radius(uint32_t joint) const {
+            return positions[joint].w;
+        }
+    };
+
+    /**
+     * Locates all joints of a hand in a single xrLocateHandJointsEXT call per hand and transposes
+     * the runtime's joint locations into HandJoints
+     */
+    class HandTracker {
+    public:
+        HandTracker() = default;
+
+        HandTracker(const HandTracker&) = delete;
+
+        HandTracker& operator=(const HandTracker&) = delete;
+
+        ~HandTracker();
+
+        // falls back to Off when the runtime or system does not support hand tracking
+        void init(const Context& context, XrSession session, HandTrackingMode mode);
+
+        void locate(XrSpace baseSpace, XrTime time);
+
+        void destroy();
+
+        [[nodiscard]]
+        bool enabled() const {
+            return m_mode != HandTrackingMode::Off;
+        }
+
+        [[nodiscard]]
+        HandTrackingMode mode() const {
+            return m_mode;
+        }
+
+        [[nodiscard]]
+        const HandJoints& operator[](Handedness hand) const {
+            return m_hands[static_cast<uint32_t>(hand)];
+        }
+
+    private:
+        static void synthesize(Handedness hand, XrTime time, HandJoints& joints);
+
+    private:
+        static constexpr auto HandCount = static_cast<uint32_t>(Handedness::Count);
+
+        HandTrackingMode m_mode{HandTrackingMode::Off};
+        std::array<HandJoints, HandCount> m_hands{};
+        std::array<XrHandTrackerEXT, HandCount> m_trackers{ XR_NULL_HANDLE, XR_NULL_HANDLE };
+        std::array<XrHandJointLocationEXT, HandJoints::Count> m_locations{};
+        PFN_xrCreateHandTrackerEXT m_createHandTracker{nullptr};
+        PFN_xrDestroyHandTrackerEXT m_destroyHandTracker{nullptr};
+        PFN_xrLocateHandJointsEXT m_locateHandJoints{nullptr};
+    };
+}
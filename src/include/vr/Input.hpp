@@ -3,11 +3,12 @@
 #include "check.hpp"
 #include <openxr/openxr.h>
 
-#include <tuple>
+#include <array>
 #include <string>
-#include <type_traits>
+#include <string_view>
 #include <format>
 #include <optional>
+#include <cstddef>
 
 namespace vr {
 
@@ -71,26 +72,50 @@ namespace vr {
             Component component;
         };
 
-        class SimpleInteractionProfile;
-
-        class OculusTouchControllerProfile;
+        inline constexpr size_t SourceCount{ static_cast<size_t>(Source::TREADMILL) + 1 };
+        inline constexpr size_t IdentifierCount{ static_cast<size_t>(Identifier::PALM) + 1 };
 
+        /**
+         * Paths of the inputs an interaction profile has, as a table indexed by source and identifier
+         * that is filled in when the profile is declared. A null entry means the profile has no
+         * such input, so looking up a path never throws
+         */
         class InteractionProfile {
         public:
-            [[nodiscard]] virtual std::string path(Identifier identifier) const = 0;
+            using IdentifierPaths = std::array<const char*, IdentifierCount>;
+
+            constexpr InteractionProfile(std::string_view profile, std::array<IdentifierPaths, SourceCount> paths)
+            : m_profile{profile}
+            , m_paths{paths}
+            {}
+
+            [[nodiscard]]
+            constexpr std::string_view profile() const {
+                return m_profile;
+            }
 
-            [[nodiscard]] virtual std::string profile() const = 0;
+            [[nodiscard]]
+            constexpr std::string_view path(Source source, Identifier identifier) const {
+                const auto path = m_paths[static_cast<size_t>(source)][static_cast<size_t>(identifier)];
+                return path ? path : std::string_view{};
+            }
 
-            [[nodiscard]] virtual std::optional<std::string> path(const Input &input) const {
-                try {
-                    return std::format("{}/{}{}", path(input.source), path(input.identifier), path(input.component));
-                }catch(...){
+            [[nodiscard]]
+            constexpr bool supports(const Input& input) const {
+                return !path(input.source, input.identifier).empty();
+            }
+
+            [[nodiscard]]
+            std::optional<std::string> path(const Input &input) const {
+                auto identifier = path(input.source, input.identifier);
+                if(identifier.empty()) {
                     return {};
                 }
+                return std::format("{}/{}{}", path(input.source), identifier, path(input.component));
             }
 
             [[nodiscard]]
-            static std::string path(Component component) {
+            static constexpr std::string_view path(Component component) {
                 switch (component) {
                     case Component::VIBRATE:
                         return "";
@@ -111,11 +136,11 @@ namespace vr {
                     case Component::POSE:
                         return "/pose";
                 }
-                THROW("INVALID COMPONENT, THIS WE SHOULD NEVER REACH HERE");
+                return "";
             }
 
             [[nodiscard]]
-            static std::string path(Source source) {
+            static constexpr std::string_view path(Source source) {
                 switch (source) {
                     case Source::LEFT_HAND:
                         return "/user/hand/left";
@@ -128,125 +153,107 @@ namespace vr {
                     case Source::TREADMILL:
                         return "/user/treadmill";
                 }
-                THROW("INVALID SOURCE, THIS WE SHOULD NEVER REACH HERE");
+                return "";
             }
 
-            static SimpleInteractionProfile Simple();
-
-            static OculusTouchControllerProfile OculusTouchController();
+            static constexpr const InteractionProfile& Simple();
 
-        protected:
-            InteractionProfile() = default;
+            static constexpr const InteractionProfile& OculusTouchController();
 
+        private:
+            std::string_view m_profile;
+            std::array<IdentifierPaths, SourceCount> m_paths;
         };
 
-        class SimpleInteractionProfile final : public InteractionProfile {
-        public:
+        namespace detail {
 
-            [[nodiscard]]
-            std::string profile() const final {
-                return "/interaction_profiles/khr/simple_controller";
-            }
+            struct IdentifierPath {
+                Identifier identifier;
+                const char* path;
+            };
 
-            [[nodiscard]]
-            std::string path(Identifier identifier) const final {
-                switch (identifier) {
-                    case Identifier::SELECT:
-                        return "input/select";
-                    case Identifier::MENU:
-                        return "input/menu";
-                    case Identifier::GRIP:
-                        return "input/grip";
-                    case Identifier::AIM:
-                        return "input/aim";
-                    case Identifier::PALM:
-                        return "input/palm_ext";
-                    case Identifier::HAPTIC:
-                        return "output/haptic";
-                    default:
-                        THROW(std::format("identifier supported for profile: {}", profile()));
+            template<size_t N>
+            constexpr InteractionProfile::IdentifierPaths identifierPaths(const IdentifierPath (&paths)[N]) {
+                InteractionProfile::IdentifierPaths result{};
+                for(const auto& [identifier, path] : paths) {
+                    result[static_cast<size_t>(identifier)] = path;
                 }
+                return result;
             }
-        };
 
-        class OculusTouchControllerProfile final : public InteractionProfile {
-        public:
-            [[nodiscard]]
-            std::string profile() const final {
-                return "/interaction_profiles/oculus/touch_controller";
+            constexpr InteractionProfile::IdentifierPaths hands(const InteractionProfile::IdentifierPaths& left
+                                                                 , const InteractionProfile::IdentifierPaths& right
+                                                                 , Source source) {
+                if(source == Source::LEFT_HAND) return left;
+                if(source == Source::RIGHT_HAND) return right;
+                return {};
             }
 
-            [[nodiscard]]
-            std::optional<std::string> path(const Input &input) const final {
-                Input aInput = input;
-                if (input.source == Source::LEFT_HAND) {
-                    switch (input.identifier) {
-                        case Identifier::A:
-                            aInput.identifier = Identifier::X;
-                            break;
-                        case Identifier::B:
-                            aInput.identifier = Identifier::Y;
-                        default:
-                            break;
-                    }
-                }
-                if (input.source == Source::RIGHT_HAND) {
-                    switch (input.identifier) {
-                        case Identifier::X:
-                            aInput.identifier = Identifier::A;
-                            break;
-                        case Identifier::Y:
-                            aInput.identifier = Identifier::B;
-                        case Identifier::MENU:
-                            THROW("identifier not supported for right hand")
-                        default:
-                            break;
-                    }
+            constexpr std::array<InteractionProfile::IdentifierPaths, SourceCount> handPaths(
+                    const InteractionProfile::IdentifierPaths& left, const InteractionProfile::IdentifierPaths& right) {
+                std::array<InteractionProfile::IdentifierPaths, SourceCount> result{};
+                for(auto source = 0u; source < SourceCount; ++source) {
+                    result[source] = hands(left, right, static_cast<Source>(source));
                 }
-                return InteractionProfile::path(aInput);
+                return result;
             }
 
-            [[nodiscard]]
-            std::string path(Identifier identifier) const final {
-                switch (identifier) {
-                    case Identifier::X:
-                        return "input/x";
-                    case Identifier::Y:
-                        return "input/y";
-                    case Identifier::A:
-                        return "input/a";
-                    case Identifier::B:
-                        return "input/b";
-                    case Identifier::MENU:
-                        return "input/menu";
-                    case Identifier::SQUEEZE:
-                        return "input/squeeze";
-                    case Identifier::TRIGGER:
-                        return "input/trigger";
-                    case Identifier::THUMB_STICK:
-                        return "input/thumbstick";
-                    case Identifier::THUMB_REST:
-                        return "input/thumbrest";
-                    case Identifier::GRIP:
-                        return "input/grip";
-                    case Identifier::AIM:
-                        return "input/aim";
-                    case Identifier::HAPTIC:
-                        return "output/haptic";
-                    case Identifier::PALM:
-                        return "input/palm_ext";
-                    default:
-                        THROW(std::format("identifier supported for profile: {}", profile()));
-                }
-            }
-        };
+            inline constexpr auto SimpleHand = identifierPaths({
+                {Identifier::SELECT, "input/select"},
+                {Identifier::MENU, "input/menu"},
+                {Identifier::GRIP, "input/grip"},
+                {Identifier::AIM, "input/aim"},
+                {Identifier::PALM, "input/palm_ext"},
+                {Identifier::HAPTIC, "output/haptic"}
+            });
+
+            // actions bound to A/B on the left hand use X/Y and the other way round on the right, menu is left hand only
+            inline constexpr auto OculusTouchLeftHand = identifierPaths({
+                {Identifier::X, "input/x"},
+                {Identifier::Y, "input/y"},
+                {Identifier::A, "input/x"},
+                {Identifier::B, "input/y"},
+                {Identifier::MENU, "input/menu"},
+                {Identifier::SQUEEZE, "input/squeeze"},
+                {Identifier::TRIGGER, "input/trigger"},
+                {Identifier::THUMB_STICK, "input/thumbstick"},
+                {Identifier::THUMB_REST, "input/thumbrest"},
+                {Identifier::GRIP, "input/grip"},
+                {Identifier::AIM, "input/aim"},
+                {Identifier::HAPTIC, "output/haptic"},
+                {Identifier::PALM, "input/palm_ext"}
+            });
+
+            inline constexpr auto OculusTouchRightHand = identifierPaths({
+                {Identifier::X, "input/a"},
+                {Identifier::Y, "input/b"},
+                {Identifier::A, "input/a"},
+                {Identifier::B, "input/b"},
+                {Identifier::SQUEEZE, "input/squeeze"},
+                {Identifier::TRIGGER, "input/trigger"},
+                {Identifier::THUMB_STICK, "input/thumbstick"},
+                {Identifier::THUMB_REST, "input/thumbrest"},
+                {Identifier::GRIP, "input/grip"},
+                {Identifier::AIM, "input/aim"},
+                {Identifier::HAPTIC, "output/haptic"},
+                {Identifier::PALM, "input/palm_ext"}
+            });
+
+            inline constexpr InteractionProfile SimpleProfile{
+                "/interaction_profiles/khr/simple_controller", handPaths(SimpleHand, SimpleHand)
+            };
+
+            inline constexpr InteractionProfile OculusTouchControllerProfile{
+                "/interaction_profiles/oculus/touch_controller", handPaths(OculusTouchLeftHand, OculusTouchRightHand)
+            };
+        }
 
-        inline SimpleInteractionProfile InteractionProfile::Simple() {
-            return SimpleInteractionProfile{};
+        constexpr const InteractionProfile& InteractionProfile::Simple() {
+            return detail::SimpleProfile;
         }
 
-        inline OculusTouchControllerProfile InteractionProfile::OculusTouchController() {
-            return OculusTouchControllerProfile{};
+        constexpr const InteractionProfile& InteractionProfile::OculusTouchController() {
+            return detail::OculusTouchControllerProfile;
         }
 
         inline XrActionType getActionType(Component component) {
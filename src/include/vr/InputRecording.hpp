@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Action.hpp"
+#include "Transforms.hpp"
+#include "SpaceLocator.hpp"
+#include "util/BoundedQueue.hpp"
+#include "util/MappedFile.hpp"
+
+#include <openxr/openxr.h>
+
+#include <array>
+#include <span>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <filesystem>
+#include <cinttypes>
+
+namespace vr {
+
+    struct RecordedView {
+        XrPosef pose{};
+        XrFovf fov{};
+    };
+
+    struct RecordedAction {
+        ActionSetId actionSet{};
+        ActionId action{};
+        bool isActive{};
+        bool changed{};
+        uint32_t type{};                 // index of the value type in ActionState
+        std::array<float, 7> value{};    // wide enough for a pose, orientation first
+    };
+
+    /**
+     * Everything the frame loop feeds the renderer with in one frame, fixed size so
+     * capturing a frame never allocates
+     */
+    struct FrameSnapshot {
+        static constexpr uint32_t MaxViews{4};
+        static constexpr uint32_t MaxSpaces{32};
+        static constexpr uint32_t MaxActions{64};
+
+        int64_t timestamp{};    // nanoseconds since the recording started
+        XrTime predictedDisplayTime{};
+        XrDuration predictedDisplayPeriod{};
+        bool shouldRender{};
+        XrViewStateFlags viewStateFlags{};
+        uint32_t viewCount{};
+        uint32_t spaceCount{};
+        uint32_t spacesLocated{};   // bit per space
+        uint32_t actionCount{};
+        std::array<RecordedView, MaxViews> views{};
+        std::array<Pose, MaxSpaces> spaces{};
+        std::array<RecordedAction, MaxActions> actions{};
+
+        void clear() {
+            viewCount = spaceCount = actionCount = 0;
+        }
+
+        void capture(const XrFrameState& frameState);
+
+        void capture(const XrViewState& viewState, std::span<const XrView> located);
+
+        void capture(const SpaceLocator& spaces);
+
+        void capture(std::span<const ActionSet> actionSets);
+
+        void apply(XrViewState& viewState, std::span<XrView> located, uint32_t& count) const;
+
+        void apply(SpaceLocator& spaces) const;
+
+        void apply(std::span<ActionSet> actionSets) const;
+    };
+
+    /**
+     * Writes captured frames to a binary log, the frame thread only copies its snapshot into a
+     * queue and a writer thread encodes it. Frames are dropped, and counted, if the writer falls behind
+     *
+     * log layout: header { magic, version } followed by frames of
+     * { size, timestamp, display time, display period, should render, view state flags,
+     *   view count, views, space count, located spaces, poses, action count, actions }
+     */
+    class InputRecorder {
+    public:
+        static constexpr uint32_t Magic{0x4C525256};   // VRRL
+        static constexpr uint32_t Version{2};
+
+        explicit InputRecorder(const std::filesystem::path& path);
+
+        InputRecorder(const InputRecorder&) = delete;
+
+        InputRecorder& operator=(const InputRecorder&) = delete;
+
+        ~InputRecorder();
+
+        // the frame being captured, it is reset by submit
+        FrameSnapshot& frame() {
+            return m_frame;
+        }
+
+        void submit();
+
+    private:
+        void run();
+
+    private:
+        std::filesystem::path m_path;
+        FrameSnapshot m_frame;
+        util::BoundedQueue<FrameSnapshot, 32> m_queue;
+        std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+        std::atomic<uint64_t> m_dropped{};
+        uint64_t m_frames{};
+        std::jthread m_writer;
+    };
+
+    enum class ReplayPacing { Recorded, AsFastAsPossible };
+
+    /**
+     * Reads a log written by InputRecorder through a memory mapping, paced either at the
+     * recorded frame timings or as fast as the frame loop runs. Loops back to the first
+     * frame at the end of the log
+     */
+    class InputReplay {
+    public:
+        InputReplay(const std::filesystem::path& path, ReplayPacing pacing);
+
+        [[nodiscard]]
+        bool isOpen() const {
+            return m_file.isOpen() && m_valid;
+        }
+
+        // decodes the next frame, waiting for its recorded time when paced
+        bool next();
+
+        [[nodiscard]]
+        const FrameSnapshot& frame() const {
+            return m_frame;
+        }
+
+    private:
+        bool decode();
+
+    private:
+        util::MappedFile m_file;
+        ReplayPacing m_pacing;
+        size_t m_offset{};
+        size_t m_firstFrame{};
+        bool m_valid{};
+        FrameSnapshot m_frame;
+        std::chrono::steady_clock::time_point m_start{};
+        uint64_t m_frames{};
+    };
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Context.hpp"
+#include "Action.hpp"
+#include "SpaceLocator.hpp"
+#include "Transforms.hpp"
+#include "util/SpscRing.hpp"
+
+#include <openxr/openxr.h>
+
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cinttypes>
+
+namespace vr {
+
+    struct PoseSample {
+        ActionSetId actionSet{};
+        ActionId action{};
+        SpaceId space{};
+        XrTime time{};                  // time the pose was located at
+        int64_t sampledAt{};            // steady clock nanoseconds when it was located
+        bool isLocated{};
+        bool hasVelocity{};
+        Pose pose{};
+        glm::vec3 linearVelocity{0};
+        glm::vec3 angularVelocity{0};
+    };
+
+    /**
+     * Age of the samples consumed by the frame thread relative to the display time of the frame
+     * that consumed them, and how regularly the sampling thread managed to take samples
+     */
+    struct InputSamplingStats {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t samples{};
+        uint64_t dropped{};
+        double latency{};               // ms, sum of predictedDisplayTime - sample time
+        double maxLatency{};
+        double interval{};              // ms, sum of the intervals between sampling passes
+        double intervalSquared{};
+        uint64_t intervals{};
+        Clock::time_point lastReport{Clock::now()};
+
+        void record(XrTime displayTime, const PoseSample& sample) {
+            const auto ms = static_cast<double>(displayTime - sample.time) * 1E-6;
+            ++samples;
+            latency += ms;
+            maxLatency = std::max(maxLatency, ms);
+        }
+
+        void recordInterval(double ms) {
+            ++intervals;
+            interval += ms;
+            intervalSquared += ms * ms;
+        }
+
+        // logs and resets the accumulated stats at most once per interval
+        void report(double targetInterval, std::chrono::seconds reportInterval = std::chrono::seconds{5});
+    };
+
+    /**
+     * Locates pose action spaces on a dedicated thread at a fixed rate and publishes the samples
+     * through a lock free ring the frame thread drains once per frame.
+     *
+     * Samples are located at the current XrTime, converted from the system clock with
+     * XR_KHR_convert_timespec_time (XR_KHR_win32_convert_performance_counter_time on windows)
+     * when the runtime has it. Without it the XrTime is estimated from the last frame's predicted
+     * display time, in which case samples are predicted at the display time instead of taken now
+     */
+    class InputSampler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr size_t RingSize{1024};
+
+        struct Source {
+            ActionSetId actionSet{};
+            ActionId action{};
+            SpaceId spaceId{};
+            XrSpace space{XR_NULL_HANDLE};
+        };
+
+        InputSampler() = default;
+
+        InputSampler(const InputSampler&) = delete;
+
+        InputSampler& operator=(const InputSampler&) = delete;
+
+        ~InputSampler();
+
+        void init(const Context& context, XrSpace baseSpace, std::vector<Source> sources);
+
+        void start(uint32_t rate);
+
+        void stop();
+
+        // frame thread, anchors the fallback time estimate to the frame being processed
+        void frame(const XrFrameState& frameState);
+
+        // frame thread, hands every sample taken since the last call to consumer
+        template<typename Consumer>
+        size_t drain(XrTime displayTime, Consumer&& consumer) {
+            return m_samples.drain([&](const PoseSample& sample){
+                // samples of one sampling pass share their timestamp
+                if(sample.sampledAt != m_lastPass) {
+                    if(m_lastPass != 0) {
+                        m_stats.recordInterval(static_cast<double>(sample.sampledAt - m_lastPass) * 1E-6);
+                    }
+                    m_lastPass = sample.sampledAt;
+                }
+                m_stats.record(displayTime, sample);
+                consumer(sample);
+            });
+        }
+
+        // frame thread
+        void report();
+
+        [[nodiscard]]
+        bool running() const {
+            return m_thread.joinable();
+        }
+
+        [[nodiscard]]
+        Clock::duration period() const {
+            return m_period;
+        }
+
+    private:
+        void run(std::stop_token stopToken);
+
+        XrTime now() const;
+
+    private:
+        XrInstance m_instance{XR_NULL_HANDLE};
+        XrSpace m_baseSpace{XR_NULL_HANDLE};
+        std::vector<Source> m_sources;
+        PFN_xrVoidFunction m_convertTime{nullptr};
+        std::atomic<int64_t> m_displayTimeOffset{};     // predicted display time - steady clock nanoseconds
+        Clock::duration m_period{};
+        util::SpscRing<PoseSample, RingSize> m_samples;
+        std::atomic<uint64_t> m_dropped{};
+        InputSamplingStats m_stats;
+        int64_t m_lastPass{};
+        std::jthread m_thread;
+    };
+}
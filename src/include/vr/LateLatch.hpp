@@ -0,0 +1,36 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cinttypes>
+
+namespace vr {
+
+    /**
+     * Poses located again right before a frame's work is submitted, renderers hand the session
+     * host visible memory of this layout (std430 compatible), e.g. from the frame ring which is flushed
+     * after the latch, and read it in their shaders instead of baking the poses into the commands they
+     * recorded earlier in the frame. Views only belong in shaders of renderers that submit the latched
+     * views with their projection layers, the compositor reprojects from the layer's poses
+     *
+     *  layout(std430) readonly buffer LatchedPoses {
+     *      mat4 views[4];
+     *      mat4 spaces[32];
+     *      uint viewCount;
+     *      uint spaceCount;
+     *  };
+     */
+    struct LatchedPoses {
+        static constexpr uint32_t MaxViews{4};
+        static constexpr uint32_t MaxSpaces{32};
+
+        std::array<glm::mat4, MaxViews> views;      // view matrices, the inverse of the located view poses
+        std::array<glm::mat4, MaxSpaces> spaces;    // model matrices of the session's spaces indexed by SpaceId
+        uint32_t viewCount;
+        uint32_t spaceCount;
+        uint32_t padding[2];
+    };
+
+    static_assert(sizeof(LatchedPoses) % 16 == 0);
+}
@@ -9,12 +9,13 @@
 #include <string>
 #include <span>
 #include <variant>
+#include <memory_resource>
 
 namespace vr {
 
     struct ViewInfo {
         XrViewState viewState;
-        std::vector<XrView> views;
+        std::span<const XrView> views;
     };
 
     struct SwapChain {
@@ -42,10 +43,19 @@ namespace vr {
 
     struct FrameInfo {
         ImageId imageId{};
+        std::span<const ImageId> images{};
         ViewInfo viewInfo{};
         XrSpace space{};
         XrTime predictedTime{};
         XrDuration predictedDuration{};
+
+        [[nodiscard]]
+        const ImageId* image(XrSwapchain swapChain) const {
+            for(const auto& image : images) {
+                if(image.swapChain == swapChain) return &image;
+            }
+            return nullptr;
+        }
     };
 
     using CompositionLayer =
@@ -67,6 +77,6 @@ namespace vr {
         }
     };
 
-    using Layers = std::vector<Layer>;
+    using Layers = std::pmr::vector<Layer>;
 
 }
\ No newline at end of file
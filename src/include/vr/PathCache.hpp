@@ -0,0 +1,42 @@
+#pragma once
+
+#include <openxr/openxr.h>
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace vr {
+
+    /**
+     * Interns path strings of an instance, each string is converted with xrStringToPath
+     * the first time it is asked for and served from the cache after that
+     */
+    class PathCache {
+    public:
+        void init(XrInstance instance) {
+            m_instance = instance;
+            m_paths.clear();
+        }
+
+        // XR_NULL_PATH if the runtime does not accept the string as a path
+        XrPath operator()(std::string_view path);
+
+        [[nodiscard]]
+        size_t size() const {
+            return m_paths.size();
+        }
+
+    private:
+        struct Hash {
+            using is_transparent = void;
+
+            size_t operator()(std::string_view value) const {
+                return std::hash<std::string_view>{}(value);
+            }
+        };
+
+        XrInstance m_instance{XR_NULL_HANDLE};
+        std::unordered_map<std::string, XrPath, Hash, std::equal_to<>> m_paths;
+    };
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Action.hpp"
+#include "SpaceLocator.hpp"
+#include "Transforms.hpp"
+
+#include <openxr/openxr.h>
+#include <glm/glm.hpp>
+
+#include <array>
+#include <vector>
+#include <map>
+#include <optional>
+#include <cinttypes>
+
+namespace vr {
+
+    struct TimedPose {
+        XrTime time{};
+        Pose pose{};
+        glm::vec3 linearVelocity{0};     // meters per second in the base space
+        glm::vec3 angularVelocity{0};    // radians per second around the base space axes
+        bool hasVelocity{};
+    };
+
+    /**
+     * The last Capacity located poses of every space ordered by XrTime, fed by the frame loop at each
+     * frame's predicted display time and by the input sampling thread when it runs. Poses between two
+     * samples are interpolated, poses after the newest sample are extrapolated from its velocity, or
+     * from the two newest samples if the runtime reported none, for at most MaxExtrapolation
+     */
+    class PoseHistory {
+    public:
+        static constexpr uint32_t Capacity{64};
+        static constexpr XrDuration MaxExtrapolation{100'000'000};    // 100 ms
+
+        void resize(size_t spaceCount) {
+            m_spaces.resize(spaceCount);
+        }
+
+        // samples older than the oldest one kept are dropped, samples with the same time replace the earlier one
+        void record(SpaceId space, const TimedPose& sample);
+
+        [[nodiscard]]
+        std::optional<TimedPose> latest(SpaceId space) const;
+
+        [[nodiscard]]
+        std::optional<Pose> at(SpaceId space, XrTime time) const;
+
+        [[nodiscard]]
+        size_t size(SpaceId space) const {
+            return space < m_spaces.size() ? m_spaces[space].count : 0;
+        }
+
+        void bind(ActionSetId actionSet, ActionId action, SpaceId space) {
+            m_actionSpaces[{ actionSet, action }] = space;
+        }
+
+        // space of a pose action
+        [[nodiscard]]
+        std::optional<SpaceId> space(ActionSetId actionSet, ActionId action) const {
+            auto itr = m_actionSpaces.find({ actionSet, action });
+            return itr != m_actionSpaces.end() ? std::optional{itr->second} : std::nullopt;
+        }
+
+        [[nodiscard]]
+        std::optional<SpaceId> space(ActionSetId actionSet, ActionHandle<Pose> action) const {
+            return space(actionSet, action.id);
+        }
+
+    private:
+        struct Ring {
+            std::array<TimedPose, Capacity> samples{};
+            uint32_t start{};
+            uint32_t count{};
+
+            const TimedPose& operator[](uint32_t index) const {
+                return samples[(start + index) % Capacity];
+            }
+
+            TimedPose& operator[](uint32_t index) {
+                return samples[(start + index) % Capacity];
+            }
+        };
+
+        static Pose extrapolate(const Ring& ring, XrTime time);
+
+    private:
+        std::vector<Ring> m_spaces;
+        std::map<std::pair<ActionSetId, ActionId>, SpaceId> m_actionSpaces;
+    };
+}
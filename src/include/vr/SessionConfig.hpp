@@ -2,11 +2,13 @@
 
 #include "check.hpp"
 #include "specification/Specifications.hpp"
+#include "HandTracking.hpp"
 
 #include <openxr/openxr.h>
 
 #include <vector>
 #include <string>
+#include <filesystem>
 
 namespace vr {
 
@@ -14,7 +16,17 @@ namespace vr {
         std::vector<SwapchainSpecification> _swapchains;
         std::vector<ReferenceSpaceSpecification> _spaces;
         std::vector<ActionSetSpecification> _actionSets;
+        std::vector<InteractionProfile> _interactionProfiles{ InteractionProfile::Simple(), InteractionProfile::OculusTouchController() };
         XrReferenceSpaceType _baseSpaceType{ XR_REFERENCE_SPACE_TYPE_VIEW };
+        bool _pipelined{false};
+        std::filesystem::path _profileOutput{"frame_profile.csv"};
+        std::filesystem::path _recordOutput;
+        std::filesystem::path _replayInput;
+        bool _replayPaced{true};
+        uint32_t _inputSampleRate{0};
+        float _poseChangeDistance{0.001f};
+        float _poseChangeAngle{0.5f};
+        HandTrackingMode _handTracking{HandTrackingMode::Off};
 
         SessionConfig& addSwapChain(const SwapchainSpecification& spec) {
             _swapchains.push_back(spec);
@@ -31,6 +43,19 @@ namespace vr {
             return *this;
         }
 
+        // profiles actions are suggested bindings for, the simple and oculus touch controllers by default
+        [[maybe_unused]]
+        SessionConfig& addInteractionProfile(const InteractionProfile& profile) {
+            _interactionProfiles.push_back(profile);
+            return *this;
+        }
+
+        [[maybe_unused]]
+        SessionConfig& clearInteractionProfiles() {
+            _interactionProfiles.clear();
+            return *this;
+        }
+
         [[maybe_unused]]
         SessionConfig& baseSpaceType() {
             return *this;
@@ -54,6 +79,78 @@ namespace vr {
             return *this;
         }
 
+        /**
+         * waits for frames on a dedicated frame pacing thread so the next frame
+         * can be prepared while the current one is still being rendered
+         */
+        [[maybe_unused]]
+        SessionConfig& pipelined(bool enabled = true) {
+            _pipelined = enabled;
+            return *this;
+        }
+
+        /**
+         * file the frame profile is written to on F12 and when the session ends,
+         * written as json if the extension is .json and as csv otherwise
+         */
+        [[maybe_unused]]
+        SessionConfig& profileOutput(const std::filesystem::path& path) {
+            _profileOutput = path;
+            return *this;
+        }
+
+        /**
+         * records the frame timing, views, space poses and action states of every frame
+         * to a binary log that can be played back with replay
+         */
+        [[maybe_unused]]
+        SessionConfig& record(const std::filesystem::path& path) {
+            _recordOutput = path;
+            return *this;
+        }
+
+        /**
+         * replaces tracked input with a log written by record, paced at the recorded frame
+         * timings or, if not paced, one recorded frame per rendered frame
+         */
+        [[maybe_unused]]
+        SessionConfig& replay(const std::filesystem::path& path, bool paced = true) {
+            _replayInput = path;
+            _replayPaced = paced;
+            return *this;
+        }
+
+        /**
+         * locates the poses of pose actions on a dedicated thread at rate Hz, renderers receive
+         * every sample taken since the previous frame. 0 disables the sampling thread
+         */
+        [[maybe_unused]]
+        SessionConfig& sampleInput(uint32_t rate = 500) {
+            _inputSampleRate = rate;
+            return *this;
+        }
+
+        /**
+         * pose actions are reported to Renderer::changed once they moved more than distance
+         * meters or rotated more than angle degrees since they were last reported
+         */
+        [[maybe_unused]]
+        SessionConfig& poseChangeThreshold(float distance, float angle) {
+            _poseChangeDistance = distance;
+            _poseChangeAngle = angle;
+            return *this;
+        }
+
+        /**
+         * locates the joints of both hands every frame and hands them to Renderer::set(const HandTracker&),
+         * HandTrackingMode::Synthetic animates a pair of hands without a runtime that supports hand tracking
+         */
+        [[maybe_unused]]
+        SessionConfig& handTracking(HandTrackingMode mode = HandTrackingMode::Runtime) {
+            _handTracking = mode;
+            return *this;
+        }
+
         void validate(const vr::Context& context) const {
             if(_swapchains.empty()) {
                 THROW("at least one swapchain should be provided")
@@ -61,6 +158,9 @@ namespace vr {
             for(const auto& actionSet : _actionSets) {
                 actionSet.validate();
             }
+            if(!_recordOutput.empty() && _recordOutput == _replayInput) {
+                THROW("a session can not record to the log it replays")
+            }
         }
     };
 }
\ No newline at end of file
@@ -6,24 +6,55 @@
 #include "graphics/Renderer.hpp"
 #include "SessionConfig.hpp"
 #include "Input.hpp"
+#include "FramePacer.hpp"
+#include "SpaceLocator.hpp"
+#include "FrameProfiler.hpp"
+#include "PathCache.hpp"
+#include "InputRecording.hpp"
+#include "InputSampler.hpp"
+#include "PoseHistory.hpp"
+#include "LateLatch.hpp"
+#include "HandTracking.hpp"
+#include "util/FrameArena.hpp"
 
 #include <openxr/openxr.h>
 
 #include <unordered_map>
 #include <memory>
 #include <span>
+#include <array>
+#include <cmath>
 
 namespace vr {
 
     struct ActionData {
         vr::Input input;
         XrAction _;
+        XrActionType type{};
+        SpaceId space{};        // only valid for pose actions
+        Pose reportedPose{};    // pose the action had when it was last reported as changed
     };
 
+    // actions are indexed by the same ActionId as the states of actionSet
     struct ActionSetBinding {
         XrActionSet xrActionSet{};
         ActionSet& actionSet;
-        std::map<std::string, ActionData> actions;
+        std::vector<ActionData> actions;
+        std::vector<ActionId> changed;
+        bool active{};
+    };
+
+    // how far a pose action has to move before it counts as changed
+    struct PoseThreshold {
+        float distance{};
+        float cosHalfAngle{1};
+
+        [[nodiscard]]
+        bool exceeded(const Pose& from, const Pose& to) const {
+            const auto offset = to.position - from.position;
+            return glm::dot(offset, offset) > distance * distance
+                || std::abs(glm::dot(from.orientation, to.orientation)) < cosHalfAngle;
+        }
     };
 
     class SessionService {
@@ -38,6 +69,9 @@ namespace vr {
         friend class SessionStopping;
         friend class SessionLossPending;
 
+        static constexpr uint32_t MaxViews{4};
+        static constexpr uint64_t HeapGuardWarmUpFrames{300};
+
         SessionService(
                 const Context &context
                 , const SessionConfig& config
@@ -56,12 +90,20 @@ namespace vr {
 
         void handleHostKeyPress(int key, int scancode, int action, int mods);
 
+        // writes the frame profile to the configured output and logs its summary
+        void dumpProfile() const;
+
         bool imageFormatIsSupported(uint64_t format);
 
         [[nodiscard]] bool isRunning() const {
             return   m_currentState != XR_SESSION_STATE_EXITING && m_currentState != XR_SESSION_STATE_LOSS_PENDING;
         }
 
+        // true while the session is in a state that waits on frames, i.e. READY through FOCUSED
+        [[nodiscard]] bool isFrameLoopActive() const {
+            return m_currentState >= XR_SESSION_STATE_READY && m_currentState <= XR_SESSION_STATE_FOCUSED;
+        }
+
         [[nodiscard]] bool shouldExit() const {
             return m_currentState == XR_SESSION_STATE_EXITING;
         }
@@ -78,7 +120,10 @@ namespace vr {
 
         void setupActions();
 
-        void bindActions(const InteractionProfile& profile);
+        void bindActions();
+
+        // synchronizes the action sets named by the renderer's activeActionSets()
+        void activateActionSets();
 
         void createSwapChain();
 
@@ -88,6 +133,25 @@ namespace vr {
 
         void transitionTo(XrSessionState state);
 
+        void stopFramePacer();
+
+        void createInputRecording();
+
+        // (re)starts the input sampler on the pose actions of the active action sets while focused, stops it otherwise
+        void updateInputSampler();
+
+        // registers the late latch with the graphics service once every space has been added
+        void setupLateLatch();
+
+        // locates the views and spaces again and writes them to the renderer's late latch target
+        void lateLatch();
+
+        // the frame being replayed, null unless replaying
+        [[nodiscard]]
+        const FrameSnapshot* replayFrame() const {
+            return m_replay && m_replay->isOpen() ? &m_replay->frame() : nullptr;
+        }
+
     private:
         const Context& m_ctx;
         const SessionConfig& m_config;
@@ -97,16 +161,33 @@ namespace vr {
         std::vector<SwapChain> m_swapchains;
         XrSessionState m_currentState{XR_SESSION_STATE_UNKNOWN};
         std::unordered_map<XrSessionState, std::unique_ptr<SessionState>> m_states;
-        std::vector<XrView> m_views;
+        std::array<XrView, MaxViews> m_views{};
+        uint32_t m_viewCount{};
+        XrViewState m_viewState{ XR_TYPE_VIEW_STATE };
         XrSpace m_baseSpace{};
-        std::map<std::string, XrSpace> m_spaces;
+        std::vector<SpaceId> m_poseActionSpaces;     // spaces of the active action sets' pose actions
         bool m_terminationRequested{};
         std::vector<ActionSetBinding> m_actionSetBindings;
         std::vector<ActionSet> m_actionSets;
         std::vector<XrActiveActionSet> m_activeActionSets;
-        std::map<std::string, XrSpace> m_actionSpaces;
+        uint64_t m_activeActionSetsVersion{};
+        PoseThreshold m_poseThreshold;
+        PathCache m_paths;
+        SpaceLocator m_spaceLocator;
         std::vector<ImageId> m_swapChainImages;
         XrEnvironmentBlendMode m_blendMode{XR_ENVIRONMENT_BLEND_MODE_OPAQUE};
+        FramePacer m_framePacer;
+        FramePacingStats m_pacingStats;
+        FrameProfiler m_profiler;
+        std::unique_ptr<InputRecorder> m_recorder;
+        std::unique_ptr<InputReplay> m_replay;
+        InputSampler m_inputSampler;
+        PoseHistory m_poseHistory;
+        HandTracker m_handTracker;
+        XrTime m_latchTime{};
+        SpaceLocator m_latchLocator;    // same spaces as m_spaceLocator, which keeps the poses the frame was recorded with
+        util::FrameArena m_frameArena;
+        uint64_t m_frameCount{};
     };
 
     class SessionState {
@@ -142,10 +223,23 @@ namespace vr {
 
         void processFrame() override;
 
+        // runs before the spaces are located, which action space locations depend on
+        virtual void syncActions() {}
+
+        // polls the action states of the last sync
+        virtual void processInput() {}
+
         virtual void endFrame();
 
         void handle(const XrEventDataSessionStateChanged &event) final;
 
+    protected:
+        bool waitFrame();
+
+        void locateViews();
+
+        void locateSpaces();
+
     protected:
         XrFrameState m_frameState{ XR_TYPE_FRAME_STATE };
 
@@ -158,8 +252,6 @@ namespace vr {
 
         void handle(const XrEventDataSessionStateChanged &event) final;
 
-        void processFrame() override;
-
         [[nodiscard]]
         XrSessionState state() const final { return XR_SESSION_STATE_IDLE; }
     };
@@ -203,9 +295,9 @@ namespace vr {
         [[nodiscard]]
         XrSessionState state() const final { return XR_SESSION_STATE_FOCUSED; }
 
-        void beginFrame() final {};
+        void syncActions() final;
 
-        void processFrame() final;
+        void processInput() final;
 
         void frameLoop(const FrameInfo &frameInfo, Layers& layers) final;
     };
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Context.hpp"
+#include "Transforms.hpp"
+
+#include <openxr/openxr.h>
+
+#include <vector>
+#include <span>
+#include <string>
+#include <string_view>
+#include <optional>
+#include <cinttypes>
+
+namespace vr {
+
+    using SpaceId = uint32_t;
+
+#ifdef XR_KHR_locate_spaces
+    using SpaceLocationData = XrSpaceLocationDataKHR;
+    using SpaceVelocityData = XrSpaceVelocityDataKHR;
+#else
+    struct SpaceLocationData {
+        XrSpaceLocationFlags locationFlags;
+        XrPosef pose;
+    };
+
+    struct SpaceVelocityData {
+        XrSpaceVelocityFlags velocityFlags;
+        XrVector3f linearVelocity;
+        XrVector3f angularVelocity;
+    };
+#endif
+
+    /**
+     * Registry of the session's spaces, spaces are registered once and referred to by the SpaceId
+     * returned from add afterwards. Only the spaces required since the last clearRequired are located,
+     * in a single xrLocateSpaces call when the runtime supports it (OpenXR 1.1 or XR_KHR_locate_spaces),
+     * otherwise one space at a time. Results are stored contiguously and indexed by SpaceId, velocities
+     * are located along with the poses and spaces that were not located read as not located
+     */
+    class SpaceLocator {
+    public:
+        void init(const Context& context, XrSession session);
+
+        // name is optional, it is only used to look the space up with find
+        SpaceId add(XrSpace space, std::string name = {});
+
+        [[nodiscard]]
+        std::optional<SpaceId> find(std::string_view name) const;
+
+        [[nodiscard]]
+        const std::string& name(SpaceId id) const {
+            return m_names[id];
+        }
+
+        // marks spaces to be located by the following calls to locate, ids required twice are located once
+        void require(SpaceId id);
+
+        void require(std::span<const SpaceId> ids) {
+            for(auto id : ids) require(id);
+        }
+
+        void clearRequired();
+
+        [[nodiscard]]
+        std::span<const SpaceId> required() const {
+            return m_required;
+        }
+
+        void locate(XrSpace baseSpace, XrTime time);
+
+        // replaces the located pose of a space, e.g. with a recorded one
+        void set(SpaceId id, const Pose& pose, bool located);
+
+        [[nodiscard]]
+        XrSpace space(SpaceId id) const {
+            return m_spaces[id];
+        }
+
+        [[nodiscard]]
+        const SpaceLocationData& operator[](SpaceId id) const {
+            return m_locations[id];
+        }
+
+        [[nodiscard]]
+        Pose pose(SpaceId id) const {
+            return convert(m_locations[id].pose);
+        }
+
+        [[nodiscard]]
+        const SpaceVelocityData& velocity(SpaceId id) const {
+            return m_velocities[id];
+        }
+
+        [[nodiscard]]
+        bool hasVelocity(SpaceId id) const {
+            constexpr XrSpaceVelocityFlags valid = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+            return (m_velocities[id].velocityFlags & valid) == valid;
+        }
+
+        [[nodiscard]]
+        bool isLocated(SpaceId id) const {
+            constexpr XrSpaceLocationFlags located = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+            return (m_locations[id].locationFlags & located) == located;
+        }
+
+        [[nodiscard]]
+        size_t size() const {
+            return m_spaces.size();
+        }
+
+        [[nodiscard]]
+        bool batched() const {
+            return m_locateSpaces != nullptr;
+        }
+
+    private:
+        std::vector<XrSpace> m_spaces;
+        std::vector<std::string> m_names;
+        std::vector<SpaceLocationData> m_locations;
+        std::vector<SpaceVelocityData> m_velocities;
+        std::vector<SpaceId> m_required;
+        std::vector<uint8_t> m_isRequired;
+
+        // gathered handles and results of the required spaces when only some of them are located in a batch
+        std::vector<XrSpace> m_batchSpaces;
+        std::vector<SpaceLocationData> m_batchLocations;
+        std::vector<SpaceVelocityData> m_batchVelocities;
+        PFN_xrVoidFunction m_locateSpaces{nullptr};
+        XrSession m_session{XR_NULL_HANDLE};
+    };
+}
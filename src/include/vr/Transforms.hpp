@@ -14,11 +14,6 @@ namespace vr {
         glm::vec3 position{0};
     };
 
-    struct SpaceLocation {
-        std::string name;
-        Pose pose;
-    };
-
     struct Transform {
         Pose pose{};
         glm::vec3 scale{1};
@@ -4,6 +4,7 @@
 #include <vulkan/vulkan.h>
 
 #include <vector>
+#include <chrono>
 #include <string>
 #include <cinttypes>
 
@@ -32,6 +33,9 @@ namespace vr {
 
         static void pollEvents();
 
+        // blocks until a window event arrives or the timeout expires
+        static void waitEvents(std::chrono::duration<double> timeout);
+
     private:
 
 
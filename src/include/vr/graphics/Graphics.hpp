@@ -10,6 +10,7 @@
 #include <utility>
 #include <vector>
 #include <memory>
+#include <functional>
 
 namespace vr {
     struct GraphicsService {
@@ -30,6 +31,15 @@ namespace vr {
 
         virtual void shutdown() {}
 
+        // called once per frame after xrBeginFrame and before the renderer records any work
+        virtual void beginFrame() {}
+
+        // called once per frame after all of the frame's work has been submitted
+        virtual void endFrame() {}
+
+        // submits outstanding uploads and blocks until they have completed
+        virtual void flush() {}
+
         virtual void setSwapChains(std::vector<SwapChain> swapchains) = 0;
 
         virtual glm::mat4 projection(const XrFovf &fov, float zNear, float zFar) {
@@ -46,7 +56,23 @@ namespace vr {
         virtual Window& window() = 0;
 #endif
 
+        // called on the frame thread right before the first queue submission of every frame, see LatchedPoses
+        void beforeSubmit(std::function<void()> callback) {
+            m_beforeSubmit = std::move(callback);
+        }
+
+    protected:
+        // implementations call this before every submission of frame work and reset m_latched in beginFrame
+        void latch() {
+            if(m_beforeSubmit && !m_latched) {
+                m_latched = true;
+                m_beforeSubmit();
+            }
+        }
+
     protected:
         const Context& m_context;
+        std::function<void()> m_beforeSubmit;
+        bool m_latched{};
     };
 }
\ No newline at end of file
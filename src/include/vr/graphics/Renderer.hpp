@@ -4,9 +4,16 @@
 #include "vr/Models.hpp"
 #include "Graphics.hpp"
 #include "vr/Action.hpp"
+#include "vr/FrameProfiler.hpp"
+#include "vr/InputSampler.hpp"
+#include "vr/PoseHistory.hpp"
+#include "vr/LateLatch.hpp"
+#include "vr/HandTracking.hpp"
 
 #include <utility>
 #include <memory>
+#include <span>
+#include <memory_resource>
 
 namespace vr {
 
@@ -19,16 +26,84 @@ namespace vr {
             m_graphics = std::move(graphics);
         }
 
+        /**
+         * memory for data that only lives until the end of the current frame,
+         * set by the session to its frame arena which is reset after xrEndFrame
+         */
+        void frameMemory(std::pmr::memory_resource* memory) {
+            m_frameMemory = memory;
+        }
+
+        [[nodiscard]]
+        std::pmr::memory_resource* frameMemory() const {
+            return m_frameMemory;
+        }
+
+        /**
+         * profiler of the session's frame loop, renderers can add phases of their own and
+         * time them with profiler().measure(phase)
+         */
+        void profiler(FrameProfiler* profiler) {
+            m_profiler = profiler;
+        }
+
+        [[nodiscard]]
+        FrameProfiler& profiler() const {
+            return *m_profiler;
+        }
+
+        /**
+         * recent poses of the session's spaces, query it for poses at times other than the
+         * frame's predicted display time
+         */
+        void poseHistory(const PoseHistory* history) {
+            m_poseHistory = history;
+        }
+
+        [[nodiscard]]
+        const PoseHistory& poseHistory() const {
+            return *m_poseHistory;
+        }
+
         virtual void beginFrame() {}
 
         virtual void endFrame() {}
 
-        virtual void set(const std::vector<SpaceLocation>& spaceLocations) {}
+        // called once before init, resolve the ids of the spaces used per frame, e.g. with spaces.find(name), here
+        virtual void bind(const SpaceLocator& spaces) {}
 
-        virtual std::vector<Vibrate> set(const ActionSet& actionSet) {
-            return {};
+        // spaces to locate this frame, asked for every frame before the spaces are located
+        virtual std::span<const SpaceId> spaces() { return {}; }
+
+        // the session's spaces located at the frame's predicted display time, only the required ones are located
+        virtual void set(const SpaceLocator& spaces) {}
+
+        // joints of both hands located at the frame's predicted display time, called every frame while hand tracking is on
+        virtual void set(const HandTracker& hands) {}
+
+        // called for every action set before init, resolve the ids of the actions used per frame here
+        virtual void bind(const ActionSet& actionSet) {}
+
+        virtual Vibrations set(const ActionSet& actionSet) {
+            return Vibrations{ m_frameMemory };
         }
 
+        /**
+         * actions of actionSet whose state changed in this frame's sync, called before set and only
+         * if something changed. Pose actions count as changed once they moved past the session's
+         * pose change threshold, their current pose can always be read from the action set
+         */
+        virtual void changed(const ActionSet& actionSet, std::span<const ActionId> actions) {}
+
+        // pose samples taken by the input sampling thread since the previous frame, oldest first
+        virtual void set(std::span<const PoseSample> poseSamples) {}
+
+        /**
+         * host visible memory the views and spaces are written to right before the frame's work is
+         * submitted, return a different buffer for each frame in flight. nullptr disables late latching
+         */
+        virtual LatchedPoses* lateLatchTarget() { return nullptr; }
+
         virtual void init() {}
 
         virtual void cleanup() {}
@@ -39,11 +114,28 @@ namespace vr {
 
         virtual void render(const FrameInfo &frameInfo, Layers& layers) = 0;
 
+        // names of the action sets to synchronize separated by '/', or "*" for all of them
         virtual std::string activeActionSets() { return "*"; };
 
+        // the session reads activeActionSets() again whenever this changes
+        [[nodiscard]]
+        uint64_t activeActionSetsVersion() const {
+            return m_activeActionSetsVersion;
+        }
+
+    protected:
+        // call after changing what activeActionSets() returns, e.g. when switching between modes
+        void activeActionSetsChanged() {
+            ++m_activeActionSetsVersion;
+        }
+
     protected:
         std::shared_ptr<GraphicsService> m_graphics;
         Context m_context;
+        std::pmr::memory_resource* m_frameMemory{std::pmr::get_default_resource()};
+        FrameProfiler* m_profiler{};
+        const PoseHistory* m_poseHistory{};
+        uint64_t m_activeActionSetsVersion{};
     };
 
     class VoidRenderer : public Renderer {
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Memory.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cstddef>
+#include <cstring>
+#include <cinttypes>
+
+namespace vr {
+
+    /**
+     * Region of the frame ring, valid until the frame slot it was allocated in is reused.
+     * offset is relative to the ring's buffer and is what gets passed as a dynamic offset
+     */
+    struct FrameAllocation {
+        VkBuffer buffer{};
+        uint32_t offset{};
+        VkDeviceSize size{};
+        std::byte* data{};
+
+        template<typename T>
+        T* as() const {
+            return reinterpret_cast<T*>(data);
+        }
+    };
+
+    /**
+     * Persistently mapped buffer split into one region per frame in flight, for data that is written
+     * once per frame and read by that frame's draws, uniforms, storage and per instance vertex data.
+     * Allocating bumps a pointer within the current frame's region, the region is reset when its
+     * frame slot comes around again, by which time the slot's fence guarantees the GPU is done with it.
+     * Every allocation is aligned for use as a dynamic uniform or storage buffer offset
+     */
+    class FrameRing {
+    public:
+        static constexpr VkDeviceSize DefaultCapacity{1024 * 1024};     // per frame in flight
+
+        // buffer holds frames regions of regionSize bytes and was created with VMA_ALLOCATION_CREATE_MAPPED_BIT
+        void init(VmaAllocator allocator, const Buffer& buffer, uint32_t frames, VkDeviceSize regionSize, VkDeviceSize alignment);
+
+        // starts allocating from the region of frameIndex, anything allocated there before is discarded
+        void begin(uint32_t frameIndex);
+
+        FrameAllocation allocate(VkDeviceSize size) {
+            const auto offset = (m_head + m_alignment - 1) & ~(m_alignment - 1);
+            if(offset + size > m_end) {
+                overflow(size);
+            }
+            m_head = offset + size;
+            return { m_buffer, static_cast<uint32_t>(offset), size, m_data + offset };
+        }
+
+        template<typename T>
+        FrameAllocation push(const T& value) {
+            auto allocation = allocate(sizeof(T));
+            std::memcpy(allocation.data, &value, sizeof(T));
+            return allocation;
+        }
+
+        // makes what was written since the last flush visible to the device, nothing to do on coherent memory
+        void flush();
+
+        [[nodiscard]]
+        VkBuffer buffer() const {
+            return m_buffer;
+        }
+
+        [[nodiscard]]
+        VkDeviceSize alignment() const {
+            return m_alignment;
+        }
+
+        // bytes allocated in the current frame
+        [[nodiscard]]
+        VkDeviceSize used() const {
+            return m_head - m_begin;
+        }
+
+    private:
+        [[noreturn]]
+        void overflow(VkDeviceSize size) const;
+
+    private:
+        VmaAllocator m_allocator{};
+        VmaAllocation m_allocation{};
+        VkBuffer m_buffer{};
+        std::byte* m_data{};
+        VkDeviceSize m_regionSize{};
+        VkDeviceSize m_alignment{};
+        VkDeviceSize m_begin{};
+        VkDeviceSize m_head{};
+        VkDeviceSize m_end{};
+        VkDeviceSize m_flushed{};
+        bool m_coherent{true};
+    };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Memory.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <functional>
+#include <vector>
+#include <cstddef>
+#include <cinttypes>
+
+namespace vr {
+
+    /**
+     * Where a link's memory came from, a slot of a pooled block or a dedicated buffer
+     * for links larger than the largest slot
+     */
+    struct LinkSlot {
+        uint32_t sizeClass{};
+        uint32_t index{};
+        VkDeviceSize size{};    // requested size
+        util::Handle<Buffer> dedicated{};
+    };
+
+    struct LinkAllocation {
+        VkBuffer buffer{};
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+        std::byte* data{};
+        LinkSlot slot{};
+    };
+
+    struct LinkPoolStats {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t links{};               // live links
+        uint64_t blocks{};              // pooled buffers and allocations backing them
+        uint64_t dedicated{};           // live links with a buffer of their own
+        uint64_t requestedBytes{};      // sum of the sizes of live links
+        uint64_t reservedBytes{};       // block and dedicated memory
+        uint64_t allocations{};
+        Clock::duration allocationTime{};
+
+        void log(const char* label) const;
+    };
+
+    /**
+     * Sub-allocates small persistently mapped buffers for Link. Slots come in power of two size
+     * classes starting at the device's offset alignment, each class carves fixed size blocks into
+     * slots and recycles them through a free list, so slot offsets are always aligned for descriptors.
+     * Blocks are created through createBlock and are kept until shutdown
+     */
+    class LinkPool {
+    public:
+        static constexpr VkDeviceSize BlockSize{256 * 1024};
+        static constexpr VkDeviceSize MaxSlotSize{BlockSize / 4};
+        static constexpr VkBufferUsageFlags Usage{
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+            | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+        };
+
+        // creates a persistently mapped buffer of the given size with Usage
+        using CreateBlock = std::function<Buffer(VkDeviceSize)>;
+
+        void init(VkDeviceSize alignment, CreateBlock createBlock);
+
+        // size must be at most MaxSlotSize, larger links get a dedicated buffer from the caller
+        LinkAllocation allocate(VkDeviceSize size);
+
+        void free(const LinkSlot& slot);
+
+        [[nodiscard]]
+        const LinkPoolStats& stats() const {
+            return m_stats;
+        }
+
+        // accounts for links the caller gave a dedicated buffer
+        LinkPoolStats& stats() {
+            return m_stats;
+        }
+
+    private:
+        struct SizeClass {
+            VkDeviceSize slotSize{};
+            uint32_t slotsPerBlock{};
+            std::vector<Buffer> blocks;
+            std::vector<uint32_t> freeSlots;    // block * slotsPerBlock + slot within the block
+        };
+
+        uint32_t sizeClassOf(VkDeviceSize size) const;
+
+    private:
+        VkDeviceSize m_alignment{};
+        CreateBlock m_createBlock;
+        std::vector<SizeClass> m_sizeClasses;
+        LinkPoolStats m_stats{};
+    };
+}
@@ -3,6 +3,8 @@
 #include <vulkan/vulkan.h>
 #include <vk_mem_alloc.h>
 
+#include "util/SlotMap.hpp"
+
 #include <cinttypes>
 #include <map>
 
@@ -12,12 +14,15 @@ namespace vr {
         VkBuffer _{};
         VkBufferCreateInfo info{};
         VmaAllocation allocation{};
+        void* mapped{};     // set for buffers allocated with VMA_ALLOCATION_CREATE_MAPPED_BIT
+        util::Handle<Buffer> id{};      // set for buffers created through VulkanGraphicsService
     };
 
     struct Image {
         VkImage handle{};
         VkImageCreateInfo info{};
         VmaAllocation allocation{};
+        util::Handle<Image> id{};       // set for images created through VulkanGraphicsService
     };
 
     struct Mapping {
@@ -52,7 +57,7 @@ namespace vr {
 
         void destroy();
 
-        Buffer allocate(VkBufferCreateInfo createInfo, VmaMemoryUsage usage);
+        Buffer allocate(VkBufferCreateInfo createInfo, VmaMemoryUsage usage, VmaAllocationCreateFlags flags = 0);
 
         Image allocate(VkImageCreateInfo createInfo, VmaMemoryUsage usage = VMA_MEMORY_USAGE_GPU_ONLY);
 
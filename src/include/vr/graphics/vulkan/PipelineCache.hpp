@@ -0,0 +1,81 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <filesystem>
+#include <vector>
+#include <cinttypes>
+
+namespace vr {
+
+    struct PipelineCacheStats {
+        using Clock = std::chrono::steady_clock;
+
+        bool warm{};                    // started from data saved by a previous run
+        uint64_t loadedBytes{};
+        uint64_t pipelines{};
+        Clock::duration creationTime{};
+
+        void log(const char* label) const;
+    };
+
+    /**
+     * VkPipelineCache persisted across runs. The file is named after the device's pipeline cache UUID
+     * and driver version, so a driver or device change starts from an empty cache, and its contents are
+     * checked against the device before they are handed to the driver. Saving writes a temporary file
+     * that replaces the previous one, an interrupted save leaves the old cache intact
+     */
+    class PipelineCache {
+    public:
+        static constexpr const char* DefaultDirectory{"pipeline_cache"};
+
+        void init(VkDevice device, const VkPhysicalDeviceProperties& properties, const std::filesystem::path& directory = DefaultDirectory);
+
+        void save();
+
+        void destroy();
+
+        [[nodiscard]]
+        VkPipelineCache handle() const {
+            return m_cache;
+        }
+
+        operator VkPipelineCache() const {
+            return m_cache;
+        }
+
+        // time pipeline creation through the cache, for reporting cold and warm starts
+        void created(PipelineCacheStats::Clock::duration duration) {
+            ++m_stats.pipelines;
+            m_stats.creationTime += duration;
+        }
+
+        [[nodiscard]]
+        const PipelineCacheStats& stats() const {
+            return m_stats;
+        }
+
+    private:
+        [[nodiscard]]
+        bool validate(const std::vector<char>& data) const;
+
+    private:
+        struct FileHeader {
+            uint32_t magic{};
+            uint32_t version{};
+            uint32_t driverVersion{};
+            uint32_t reserved{};
+            uint64_t dataSize{};
+        };
+
+        static constexpr uint32_t Magic{0x43505256};    // "VRPC"
+        static constexpr uint32_t Version{1};
+
+        VkDevice m_device{VK_NULL_HANDLE};
+        VkPipelineCache m_cache{VK_NULL_HANDLE};
+        VkPhysicalDeviceProperties m_properties{};
+        std::filesystem::path m_path;
+        PipelineCacheStats m_stats{};
+    };
+}
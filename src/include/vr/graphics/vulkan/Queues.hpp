@@ -0,0 +1,104 @@
+#pragma once
+
+#include "xr_struct_mapping.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <cinttypes>
+
+namespace vr {
+
+    struct Queue {
+        VkQueue _{VK_NULL_HANDLE};
+        uint32_t familyIndex{VK_QUEUE_FAMILY_IGNORED};
+
+        [[nodiscard]]
+        bool sameFamily(const Queue& other) const {
+            return familyIndex == other.familyIndex;
+        }
+    };
+
+    /**
+     * Queue family ownership transfer of an exclusive resource, the release barrier is recorded on a
+     * queue of the source family and the acquire barrier, with the same parameters, on a queue of the
+     * destination family. The acquiring submission has to wait on the releasing one.
+     * When both families are the same the barriers are plain barriers with ignored family indices
+     */
+    struct OwnershipTransfer {
+        uint32_t srcFamilyIndex{VK_QUEUE_FAMILY_IGNORED};
+        uint32_t dstFamilyIndex{VK_QUEUE_FAMILY_IGNORED};
+
+        OwnershipTransfer() = default;
+
+        OwnershipTransfer(const Queue& src, const Queue& dst)
+        : srcFamilyIndex{src.familyIndex}
+        , dstFamilyIndex{dst.familyIndex}
+        {
+            if(!required()) {
+                srcFamilyIndex = dstFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            }
+        }
+
+        [[nodiscard]]
+        bool required() const {
+            return srcFamilyIndex != dstFamilyIndex;
+        }
+
+        [[nodiscard]]
+        VkBufferMemoryBarrier release(VkBuffer buffer, VkAccessFlags srcAccess
+                                      , VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const {
+            auto barrier = bufferBarrier(buffer, offset, size);
+            barrier.srcAccessMask = srcAccess;
+            return barrier;
+        }
+
+        [[nodiscard]]
+        VkBufferMemoryBarrier acquire(VkBuffer buffer, VkAccessFlags dstAccess
+                                      , VkDeviceSize offset = 0, VkDeviceSize size = VK_WHOLE_SIZE) const {
+            auto barrier = bufferBarrier(buffer, offset, size);
+            barrier.dstAccessMask = dstAccess;
+            return barrier;
+        }
+
+        [[nodiscard]]
+        VkImageMemoryBarrier release(VkImage image, const VkImageSubresourceRange& range
+                                     , VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags srcAccess) const {
+            auto barrier = imageBarrier(image, range, oldLayout, newLayout);
+            barrier.srcAccessMask = srcAccess;
+            return barrier;
+        }
+
+        [[nodiscard]]
+        VkImageMemoryBarrier acquire(VkImage image, const VkImageSubresourceRange& range
+                                     , VkImageLayout oldLayout, VkImageLayout newLayout, VkAccessFlags dstAccess) const {
+            auto barrier = imageBarrier(image, range, oldLayout, newLayout);
+            barrier.dstAccessMask = dstAccess;
+            return barrier;
+        }
+
+    private:
+        [[nodiscard]]
+        VkBufferMemoryBarrier bufferBarrier(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize size) const {
+            auto barrier = makeStruct<VkBufferMemoryBarrier>();
+            barrier.srcQueueFamilyIndex = srcFamilyIndex;
+            barrier.dstQueueFamilyIndex = dstFamilyIndex;
+            barrier.buffer = buffer;
+            barrier.offset = offset;
+            barrier.size = size;
+            return barrier;
+        }
+
+        [[nodiscard]]
+        VkImageMemoryBarrier imageBarrier(VkImage image, const VkImageSubresourceRange& range
+                                          , VkImageLayout oldLayout, VkImageLayout newLayout) const {
+            auto barrier = makeStruct<VkImageMemoryBarrier>();
+            barrier.srcQueueFamilyIndex = srcFamilyIndex;
+            barrier.dstQueueFamilyIndex = dstFamilyIndex;
+            barrier.oldLayout = oldLayout;
+            barrier.newLayout = newLayout;
+            barrier.image = image;
+            barrier.subresourceRange = range;
+            return barrier;
+        }
+    };
+}
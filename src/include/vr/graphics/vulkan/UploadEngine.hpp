@@ -0,0 +1,202 @@
+#pragma once
+
+#include "Memory.hpp"
+#include "Queues.hpp"
+
+#include <vulkan/vulkan.h>
+
+#include <chrono>
+#include <deque>
+#include <vector>
+#include <span>
+#include <cstddef>
+
+namespace vr {
+
+    struct WaitSemaphore {
+        VkSemaphore _{};
+        VkPipelineStageFlags stage{};
+        uint64_t value{};   // only used for timeline semaphores
+    };
+
+    /**
+     * Completion token of a submitted upload batch, the batch has completed once the
+     * upload engine's timeline semaphore reaches value
+     */
+    struct UploadToken {
+        uint64_t value{};
+
+        [[nodiscard]]
+        bool valid() const {
+            return value != 0;
+        }
+    };
+
+    /**
+     * Region of staging memory, offsets of copies recorded from an allocation are relative to it
+     */
+    struct StagingAllocation {
+        VkBuffer buffer{};
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+        std::byte* data{};
+
+        template<typename T>
+        T* as() const {
+            return reinterpret_cast<T*>(data);
+        }
+    };
+
+    struct UploadStats {
+        using Clock = std::chrono::steady_clock;
+
+        uint64_t bytes{};
+        uint64_t regions{};
+        uint64_t batches{};
+        uint64_t dedicatedBuffers{};
+        uint64_t ringWaits{};
+        Clock::duration ringWaitTime{};
+        Clock::time_point firstSubmit{};
+        Clock::time_point lastCompletion{};
+
+        void log(const char* label) const;
+    };
+
+    /**
+     * Records uploads into batches that are submitted asynchronously, each submit returns a token
+     * that can be waited on or chained into other submissions. Staging memory comes from a
+     * persistently mapped ring that is reclaimed as batches complete, uploads larger than the ring
+     * get a dedicated staging buffer that is released with its batch.
+     *
+     * Batches run on the transfer queue, when it belongs to a different family than the graphics queue
+     * every destination is released to the graphics family and acquired by a small submission on the
+     * graphics queue that waits for the batch. Tokens complete once the acquire has executed, so uploaded
+     * resources are ready for graphics as soon as their token is. Destinations are exclusive resources,
+     * their previous contents are discarded by the transfer.
+     * Not thread safe, it is driven by the thread that owns the graphics queue
+     */
+    class UploadEngine {
+    public:
+        static constexpr VkDeviceSize DefaultCapacity{64 * 1024 * 1024};
+        static constexpr size_t MaxWaitSemaphores{8};
+        static constexpr size_t MaxSignalSemaphores{8};
+
+        void init(VkDevice device, VmaMemoryAllocator& allocator, const Queue& transfer, const Queue& graphics
+                  , VkDeviceSize capacity = DefaultCapacity);
+
+        void shutdown();
+
+        StagingAllocation stage(VkDeviceSize size, VkDeviceSize alignment = 16);
+
+        StagingAllocation stage(const void* data, VkDeviceSize size);
+
+        void copy(const StagingAllocation& source, VkBuffer destination, VkDeviceSize dstOffset = 0);
+
+        void copy(VkBuffer source, VkBuffer destination, std::span<const VkBufferCopy> regions);
+
+        // transitions the image from oldLayout to transfer destination, copies and transitions it to newLayout
+        void copyToImage(const StagingAllocation& source, VkImage image, std::span<const VkBufferImageCopy> regions
+                         , const VkImageSubresourceRange& range, VkImageLayout oldLayout, VkImageLayout newLayout);
+
+        // operation runs on the transfer queue, it is responsible for releasing what it writes to the graphics family
+        template<typename Operation>
+        void record(Operation&& operation) {
+            operation(commandBuffer());
+            m_recordedEnd = m_head;
+        }
+
+        // submits everything recorded since the last submit, at most MaxWaitSemaphores waits and MaxSignalSemaphores signals
+        UploadToken submit(std::span<const WaitSemaphore> waits = {}, std::span<const VkSemaphore> signals = {});
+
+        [[nodiscard]]
+        bool isComplete(UploadToken token) const;
+
+        void wait(UploadToken token);
+
+        // reclaims staging memory and command buffers of completed batches
+        void collect();
+
+        // wait on the token's batch from another submission
+        [[nodiscard]]
+        WaitSemaphore waitSemaphore(UploadToken token, VkPipelineStageFlags stage) const {
+            return { m_timeline, stage, token.value };
+        }
+
+        [[nodiscard]]
+        UploadToken last() const {
+            return { m_submitted };
+        }
+
+        // token of the batch being recorded, it completes once the batch is submitted and has executed
+        [[nodiscard]]
+        UploadToken open() const {
+            return { m_recording ? m_submitted + 1 : m_submitted };
+        }
+
+        [[nodiscard]]
+        bool pending() const {
+            return m_recording != VK_NULL_HANDLE;
+        }
+
+        [[nodiscard]]
+        const UploadStats& stats() const {
+            return m_stats;
+        }
+
+        [[nodiscard]]
+        OwnershipTransfer ownership() const {
+            return { m_transfer, m_graphics };
+        }
+
+        [[nodiscard]]
+        bool crossFamily() const {
+            return !m_transfer.sameFamily(m_graphics);
+        }
+
+    private:
+        struct Batch {
+            VkCommandBuffer commandBuffer{};
+            VkCommandBuffer acquireCommandBuffer{};
+            uint64_t value{};
+            uint64_t ringEnd{};
+            std::vector<Buffer> dedicated;
+        };
+
+        VkCommandBuffer commandBuffer();
+
+        VkCommandBuffer acquireCommandBuffer();
+
+        static VkCommandBuffer allocate(VkDevice device, VkCommandPool pool, std::vector<VkCommandBuffer>& freeList);
+
+        StagingAllocation dedicated(VkDeviceSize size);
+
+        void waitValue(uint64_t value);
+
+    private:
+        VkDevice m_device{};
+        VmaMemoryAllocator* m_allocator{};
+        Queue m_transfer{};
+        Queue m_graphics{};
+        VkCommandPool m_commandPool{};
+        VkCommandPool m_acquirePool{};
+        VkSemaphore m_timeline{};
+        VkSemaphore m_transferTimeline{};   // only used when the transfer queue is a separate family
+        uint64_t m_submitted{};
+
+        Buffer m_ring{};
+        std::byte* m_ringData{};
+        VkDeviceSize m_capacity{};
+        uint64_t m_head{};
+        uint64_t m_tail{};
+        uint64_t m_recordedEnd{};   // ring end of the staging memory copies have been recorded from
+
+        VkCommandBuffer m_recording{};
+        std::vector<Buffer> m_dedicated;
+        std::deque<Batch> m_inFlight;
+        std::vector<VkCommandBuffer> m_freeCommandBuffers;
+        std::vector<VkCommandBuffer> m_freeAcquireCommandBuffers;
+        std::vector<VkBufferMemoryBarrier> m_bufferAcquires;
+        std::vector<VkImageMemoryBarrier> m_imageAcquires;
+        UploadStats m_stats;
+    };
+}
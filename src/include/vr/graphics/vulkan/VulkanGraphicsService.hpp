@@ -15,25 +15,74 @@
 
 #include "Memory.hpp"
 #include "MirrorSwapChain.hpp"
+#include "UploadEngine.hpp"
+#include "FrameRing.hpp"
+#include "LinkPool.hpp"
+#include "PipelineCache.hpp"
+#include "Queues.hpp"
+#include "util/SlotMap.hpp"
 #include <stdexcept>
 #include <sstream>
 #include <format>
 #include <span>
+#include <array>
+#include <tuple>
+#include <chrono>
+#include <variant>
 
 #include <filesystem>
 
 namespace vr {
 
+    /**
+     * Persistently mapped object shared with the GPU, written through cpu and bound as buffer and offset.
+     * Links are sub-allocated from pooled blocks, hand it to VulkanGraphicsService::release when done
+     */
     template<typename T>
     struct Link {
         T* cpu{};
-        Mapping gpu{};
+        VkBuffer buffer{};
+        VkDeviceSize offset{};
+        VkDeviceSize size{};
+        LinkSlot slot{};
 
-        void unlink() {
-            gpu.unmap();
+        [[nodiscard]]
+        VkDescriptorBufferInfo descriptor() const {
+            return { buffer, offset, size };
+        }
+    };
+
+    /**
+     * Vulkan object created through VulkanGraphicsService, converts to the raw handle and can be
+     * handed back to VulkanGraphicsService::release to destroy it before shutdown
+     */
+    template<typename T>
+    struct Resource {
+        T _{};
+        util::Handle<T> id{};
+
+        operator T() const {
+            return _;
         }
     };
 
+    // live objects per resource kind
+    struct ResourceCounts {
+        size_t buffers{};
+        size_t mappings{};
+        size_t images{};
+        size_t imageViews{};
+        size_t shaderModules{};
+        size_t pipelines{};
+        size_t pipelineLayouts{};
+        size_t descriptorSetLayouts{};
+        size_t descriptorPools{};
+        size_t renderPasses{};
+        size_t frameBuffers{};
+        size_t commandPools{};
+        size_t retired{};       // released, waiting for the GPU to be done with them
+    };
+
     struct CopyRequest {
         Buffer source;
         ImageId imageId;
@@ -41,13 +90,26 @@ namespace vr {
         uint32_t  arrayLayer{0};
     };
 
-    struct WaitSemaphore {
-        VkSemaphore _{};
-        VkPipelineStageFlags stage{};
+    /**
+     * Per frame resources of one slot in the frames in flight ring, the fence is signaled once
+     * all work submitted during the slot's frame has completed
+     */
+    struct FrameContext {
+        static constexpr uint32_t MaxCommandBuffers{16};
+
+        VkFence fence{};
+        VkCommandPool commandPool{};
+        std::array<VkCommandBuffer, MaxCommandBuffers> commandBuffers{};
+        uint32_t numAllocated{};
+        uint32_t numUsed{};
+        uint64_t frame{};       // frame number the fence was last submitted with
+        bool inFlight{};
     };
 
     class VulkanGraphicsService final : public GraphicsService {
     public:
+        static constexpr uint32_t MaxFramesInFlight{2};
+
         explicit VulkanGraphicsService(const Context &context);
 
         ~VulkanGraphicsService() final = default;
@@ -68,10 +130,64 @@ namespace vr {
 
         Buffer createMappableBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
 
-        void release(Buffer buffer);
+        // mapped for its whole lifetime, write through Buffer::mapped
+        Buffer createPersistentlyMappedBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+
+        /**
+         * releasing an object retires it with the current frame, it is destroyed once the GPU has
+         * completed that frame and, when given, the upload batch of after. The handle must not be
+         * recorded into new work after it is released
+         */
+        void release(Buffer buffer, UploadToken after = {});
+
+        void release(const Image& image, UploadToken after = {});
+
+        template<typename T>
+        void release(const Resource<T>& resource, UploadToken after = {}) {
+            if(auto object = resources<T>().erase(resource.id)) {
+                retire(*object, after);
+            }
+        }
+
+        template<typename T>
+        void release(const Link<T>& link, UploadToken after = {}) {
+            releaseLink(link.slot, after);
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        T get(util::Handle<T> id) const {
+            auto object = resources<T>().find(id);
+            return object ? *object : T{};
+        }
+
+        [[nodiscard]]
+        ResourceCounts liveResources() const;
 
         [[nodiscard]] VkQueue queue() const;
 
+        [[nodiscard]]
+        Queue graphicsQueue() const {
+            return { m_graphicsQueue, m_graphicsFamilyIndex };
+        }
+
+        // dedicated transfer queue if the device has one, the graphics queue otherwise
+        [[nodiscard]]
+        const Queue& transferQueue() const {
+            return m_transferQueue;
+        }
+
+        // dedicated compute queue if the device has one, the graphics queue otherwise
+        [[nodiscard]]
+        const Queue& computeQueue() const {
+            return m_computeQueue;
+        }
+
+        [[nodiscard]]
+        OwnershipTransfer ownership(const Queue& src, const Queue& dst) const {
+            return { src, dst };
+        }
+
         [[nodiscard]] VkDevice device() const {
             return m_device;
         }
@@ -82,78 +198,87 @@ namespace vr {
 
         void shutdown() final;
 
+        void beginFrame() final;
+
+        void endFrame() final;
+
+        void flush() final;
+
+        // command buffers owned by the current frame slot, they are reset when the slot is reused
+        std::span<VkCommandBuffer> frameCommandBuffers(uint32_t count);
+
+        [[nodiscard]]
+        uint32_t frameIndex() const {
+            return m_frameIndex;
+        }
+
         glm::mat4 projection(const XrFovf &fov, float zNear, float zFar) final;
 
         VkCommandBuffer commandBuffer(uint32_t imageIndex);
 
         static std::shared_ptr<GraphicsService> shared(const Context& context);
 
+        // a buffer is mapped once, mapping it again returns the existing mapping
         Mapping map(const Buffer& buffer) const {
-            Mapping mapping{};
-            mapping.allocation = buffer.allocation;
-            mapping.allocator = allocator.allocator;
-            vmaMapMemory(allocator.allocator, buffer.allocation, &mapping._);
-            m_mappings.push_back(mapping);
-            return mapping;
+            auto& tracked = m_buffers[buffer.id];
+            if(!tracked.mapping._) {
+                tracked.mapping.allocation = buffer.allocation;
+                tracked.mapping.allocator = allocator.allocator;
+                vmaMapMemory(allocator.allocator, buffer.allocation, &tracked.mapping._);
+            }
+            return tracked.mapping;
         }
 
 
+        /**
+         * records operation, submits it to the graphics queue and blocks until it completes,
+         * uploads should be recorded through uploads() instead
+         */
         void scoped(auto&& operation, const std::vector<WaitSemaphore>& waits = {}, const std::vector<VkSemaphore>& signals = {}) {
-            auto allocateInfo = makeStruct<VkCommandBufferAllocateInfo>();
-            allocateInfo.commandPool = m_scopedCommandPool;
-            allocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-            allocateInfo.commandBufferCount = 1;
-
-            VkCommandBuffer commandBuffer;
-            vkAllocateCommandBuffers(m_device, &allocateInfo, &commandBuffer);
-
-            auto beginInfo = makeStruct<VkCommandBufferBeginInfo>();
-            beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-            vkBeginCommandBuffer(commandBuffer, &beginInfo);
+            auto commandBuffer = beginScoped();
             operation(commandBuffer);
-            vkEndCommandBuffer(commandBuffer);
-
-            std::vector<VkSemaphore> waitSemaphores;
-            std::vector<VkPipelineStageFlags> waitStages;
-            for(auto semaphore : waits) {
-                waitSemaphores.push_back(semaphore._);
-                waitStages.push_back(semaphore.stage);
-            }
-
+            endScoped(commandBuffer, waits, signals);
+        }
 
-            auto submitInfo = makeStruct<VkSubmitInfo>();
-            submitInfo.pCommandBuffers = &commandBuffer;
-            submitInfo.commandBufferCount = 1;
-            submitInfo.waitSemaphoreCount = waitSemaphores.size();
-            submitInfo.pWaitSemaphores = waitSemaphores.data();
-            submitInfo.pWaitDstStageMask = waitStages.data();
-            submitInfo.signalSemaphoreCount = signals.size();
-            submitInfo.pSignalSemaphores = signals.data();
+        UploadEngine& uploads() {
+            return m_uploads;
+        }
 
-            CHECK_VULKAN(vkQueueSubmit(m_graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE));
-            vkQueueWaitIdle(m_graphicsQueue);
-            vkFreeCommandBuffers(m_device, m_scopedCommandPool, 1, &commandBuffer);
+        // per frame uniform, storage and instance data, reset at the start of every frame
+        FrameRing& frameRing() {
+            return m_frameRing;
         }
 
-        VkImageView createImageView(VkImageViewCreateInfo createInfo);
+        Resource<VkImageView> createImageView(VkImageViewCreateInfo createInfo);
 
-        void copyToImage(const CopyRequest& request);
+        // recorded into the open upload batch, which goes out with the next frame or flush,
+        // request.source must stay alive until the returned token completes
+        UploadToken copyToImage(const CopyRequest& request);
 
-        void copy(const Buffer& src, const Buffer& dst, VkDeviceSize size, VkDeviceSize offset = 0u, VkDeviceSize dstOffset = 0u);
+        // recorded into the open upload batch, src must stay alive until the returned token completes
+        UploadToken copy(const Buffer& src, const Buffer& dst, VkDeviceSize size, VkDeviceSize offset = 0u, VkDeviceSize dstOffset = 0u);
 
+        // usage must be covered by LinkPool::Usage, it is only checked in debug builds
         template<typename T>
         Link<T> link(VkBufferUsageFlagBits usage, uint32_t count = 1) {
-            auto buffer = createMappableBuffer(sizeof(T) * count, usage);
-            Link<T> link{};
-            link.gpu = map(buffer);
-            link.cpu = link.gpu.template as<T>();
-            return link;
+            assert((usage & ~LinkPool::Usage) == 0);
+            const auto allocation = allocateLink(sizeof(T) * count);
+            return { reinterpret_cast<T*>(allocation.data), allocation.buffer, allocation.offset, allocation.size, allocation.slot };
+        }
+
+        [[nodiscard]]
+        const LinkPoolStats& linkStats() const {
+            return m_links.stats();
+        }
+
+        [[nodiscard]]
+        const PipelineCacheStats& pipelineCacheStats() const {
+            return m_pipelineCache.stats();
         }
 
-        VkDescriptorPool createDescriptorPool(const VkDescriptorPoolCreateInfo& createInfo);
+        Resource<VkDescriptorPool> createDescriptorPool(const VkDescriptorPoolCreateInfo& createInfo);
 
-        VkDescriptorSetLayout createDescriptorSetLayout(VkDescriptorSetLayoutCreateInfo createInfo);
+        Resource<VkDescriptorSetLayout> createDescriptorSetLayout(VkDescriptorSetLayoutCreateInfo createInfo);
 
         std::vector<VkDescriptorSet> allocate(VkDescriptorPool pool, VkDescriptorSetLayout layout, uint32_t numSets = 1);
 
@@ -161,22 +286,24 @@ namespace vr {
 
         std::span<VkCommandBuffer> allocateCommandBuffers(uint32_t size);
 
-        VkShaderModule createShaderModule(const std::filesystem::path &path);
+        Resource<VkShaderModule> createShaderModule(const std::filesystem::path &path);
 
-        VkPipelineLayout createPipelineLayout(const VkPipelineLayoutCreateInfo &createInfo);
+        Resource<VkPipelineLayout> createPipelineLayout(const VkPipelineLayoutCreateInfo &createInfo);
 
-        VkPipeline createGraphicsPipeline(const VkGraphicsPipelineCreateInfo &createInfo);
+        Resource<VkPipeline> createGraphicsPipeline(const VkGraphicsPipelineCreateInfo &createInfo);
 
-        VkRenderPass createRenderPass(const VkRenderPassCreateInfo &createInfo);
+        Resource<VkRenderPass> createRenderPass(const VkRenderPassCreateInfo &createInfo);
 
-        VkFramebuffer createFrameBuffer(const VkFramebufferCreateInfo &createInfos);
+        Resource<VkFramebuffer> createFrameBuffer(const VkFramebufferCreateInfo &createInfos);
 
-        std::vector<VkFramebuffer> createFrameBuffers(const std::vector<VkFramebufferCreateInfo> &createInfos);
+        std::vector<Resource<VkFramebuffer>> createFrameBuffers(const std::vector<VkFramebufferCreateInfo> &createInfos);
 
         Image creatImage(const VkImageCreateInfo &createInfo);
 
         void submitToGraphicsQueue(const VkSubmitInfo &submitInfo);
 
+        void submitToComputeQueue(const VkSubmitInfo &submitInfo, VkFence fence = VK_NULL_HANDLE);
+
 #ifdef USE_MIRROR_WINDOW
         void initMirrorWindow() final;
 
@@ -215,6 +342,18 @@ namespace vr {
 
         void createInternalCommandPool();
 
+        void createFrameContexts();
+
+        void createFrameRing();
+
+        void createLinkPool();
+
+        void createPipelineCache();
+
+        LinkAllocation allocateLink(VkDeviceSize size);
+
+        void releaseLink(const LinkSlot& slot, UploadToken after);
+
         void initMemoryAllocator();
 
         void initializeGraphicsBinding();
@@ -223,34 +362,117 @@ namespace vr {
         
         void initGuard() const;
 
+        VkCommandBuffer beginScoped();
+
+        void endScoped(VkCommandBuffer commandBuffer, const std::vector<WaitSemaphore>& waits, const std::vector<VkSemaphore>& signals);
+
         void transition(const std::vector<VkImage>& images, const std::vector<VkImageLayout>& oldLayouts, const std::vector<VkImageLayout>& newLayouts);
 
+        Buffer track(Buffer buffer);
+
+        template<typename T>
+        Resource<T> track(T object) {
+            return { object, resources<T>().insert(object) };
+        }
+
+        template<typename T>
+        util::SlotMap<T>& resources() {
+            return std::get<util::SlotMap<T>>(m_resources);
+        }
+
+        template<typename T>
+        const util::SlotMap<T>& resources() const {
+            return std::get<util::SlotMap<T>>(m_resources);
+        }
+
+        struct TrackedBuffer {
+            Buffer buffer;
+            Mapping mapping;    // set once the buffer is mapped through map
+        };
+
+        using RetiredObject = std::variant<TrackedBuffer, Image, LinkSlot, VkImageView, VkShaderModule, VkPipeline, VkPipelineLayout
+                                           , VkDescriptorSetLayout, VkDescriptorPool, VkRenderPass, VkFramebuffer, VkCommandPool>;
+
+        struct Retired {
+            uint64_t frame{};
+            UploadToken upload{};
+            RetiredObject object;
+        };
+
+        void retire(RetiredObject object, UploadToken after);
+
+        // destroys retired objects the GPU is done with, all of them when force is set
+        void reclaim(bool force = false);
+
+        void destroy(TrackedBuffer& tracked);
+
+        void destroy(const Image& image);
+
+        void destroy(const LinkSlot& slot);
+
+        void destroy(VkImageView view);
+
+        void destroy(VkShaderModule shaderModule);
+
+        void destroy(VkPipeline pipeline);
+
+        void destroy(VkPipelineLayout layout);
+
+        void destroy(VkDescriptorSetLayout setLayout);
+
+        void destroy(VkDescriptorPool pool);
+
+        void destroy(VkRenderPass renderPass);
+
+        void destroy(VkFramebuffer frameBuffer);
+
+        void destroy(VkCommandPool commandPool);
+
     private:
         XrGraphicsBindingVulkanKHR m_bindingInfo{ XR_TYPE_GRAPHICS_BINDING_VULKAN2_KHR };
         VkPhysicalDevice m_physicalDevice{VK_NULL_HANDLE};
         VkDevice m_device{VK_NULL_HANDLE};
         VkQueue m_graphicsQueue{VK_NULL_HANDLE};
         uint32_t m_graphicsFamilyIndex{};
+        Queue m_transferQueue{};
+        Queue m_computeQueue{};
         std::vector<XrVulkanSwapChain> m_swapChains;
         VmaMemoryAllocator allocator;
+        UploadEngine m_uploads;
+        FrameRing m_frameRing;
+        LinkPool m_links;
+        PipelineCache m_pipelineCache;
+        std::chrono::steady_clock::time_point m_initStart{};
+        VkDeviceSize m_offsetAlignment{};   // for uniform and storage buffer offsets
         VkCommandPool m_commandPool;
-        VkCommandPool m_scopedCommandPool;
+        VkCommandBuffer m_scopedCommandBuffer{VK_NULL_HANDLE};
+        VkFence m_scopedFence{VK_NULL_HANDLE};
         static constexpr uint32_t MaxCommandBuffers{100};
+        static constexpr uint32_t RetiredCapacity{256};
         std::vector<VkCommandBuffer> m_commandBuffers;
         uint32_t numCommandBuffers{};
         bool initialized{false};
-        mutable std::vector<Buffer> m_buffers;
-        mutable std::vector<Mapping> m_mappings;
-        mutable std::vector<VkCommandPool> m_commandPools;
-        mutable std::vector<VkDescriptorPool> m_descriptorPools;
-        mutable std::vector<VkDescriptorSetLayout> m_descriptorSetLayouts;
-        mutable std::vector<VkPipelineLayout> m_pipelineLayouts;
-        mutable std::vector<VkPipeline> m_pipelines;
-        mutable std::vector<VkRenderPass> m_renderPasses;
-        mutable std::vector<VkFramebuffer> m_frameBuffers;
-        mutable std::vector<Image> m_images;
-        mutable std::vector<VkImageView> m_imageViews;
-        mutable std::vector<VkShaderModule> m_shaders;
+        std::array<FrameContext, MaxFramesInFlight> m_frameContexts{};
+        uint64_t m_frameCount{};
+        uint64_t m_completedFrame{};    // every frame up to this one has completed on the GPU
+        uint32_t m_frameIndex{};
+        std::vector<Retired> m_retired;
+
+        mutable util::SlotMap<TrackedBuffer, Buffer> m_buffers;
+        util::SlotMap<Image> m_images;
+
+        // non-dispatchable handles are distinct pointer types on 64-bit targets, which is what keeps the kinds apart
+        std::tuple<
+            util::SlotMap<VkImageView>,
+            util::SlotMap<VkShaderModule>,
+            util::SlotMap<VkPipeline>,
+            util::SlotMap<VkPipelineLayout>,
+            util::SlotMap<VkDescriptorSetLayout>,
+            util::SlotMap<VkDescriptorPool>,
+            util::SlotMap<VkRenderPass>,
+            util::SlotMap<VkFramebuffer>,
+            util::SlotMap<VkCommandPool>
+        > m_resources;
 
 #ifdef USE_MIRROR_WINDOW
         Window m_window{};
@@ -19,6 +19,11 @@ inline XrApiLayerProperties makeStruct<XrApiLayerProperties>() {
     return { XR_TYPE_API_LAYER_PROPERTIES };
 }
 
+template<>
+inline XrExtensionProperties makeStruct<XrExtensionProperties>() {
+    return { XR_TYPE_EXTENSION_PROPERTIES };
+}
+
 template<>
 inline XrInstanceCreateInfo makeStruct<XrInstanceCreateInfo>() {
     return { XR_TYPE_INSTANCE_CREATE_INFO };
@@ -171,6 +176,48 @@ inline XrSpaceLocation makeStruct<XrSpaceLocation>() {
     return { XR_TYPE_SPACE_LOCATION };
 }
 
+template<>
+inline XrSpaceVelocity makeStruct<XrSpaceVelocity>() {
+    return { XR_TYPE_SPACE_VELOCITY };
+}
+
+template<>
+inline XrSystemHandTrackingPropertiesEXT makeStruct<XrSystemHandTrackingPropertiesEXT>() {
+    return { XR_TYPE_SYSTEM_HAND_TRACKING_PROPERTIES_EXT };
+}
+
+template<>
+inline XrHandTrackerCreateInfoEXT makeStruct<XrHandTrackerCreateInfoEXT>() {
+    return { XR_TYPE_HAND_TRACKER_CREATE_INFO_EXT };
+}
+
+template<>
+inline XrHandJointsLocateInfoEXT makeStruct<XrHandJointsLocateInfoEXT>() {
+    return { XR_TYPE_HAND_JOINTS_LOCATE_INFO_EXT };
+}
+
+template<>
+inline XrHandJointLocationsEXT makeStruct<XrHandJointLocationsEXT>() {
+    return { XR_TYPE_HAND_JOINT_LOCATIONS_EXT };
+}
+
+#ifdef XR_KHR_locate_spaces
+template<>
+inline XrSpacesLocateInfoKHR makeStruct<XrSpacesLocateInfoKHR>() {
+    return { XR_TYPE_SPACES_LOCATE_INFO_KHR };
+}
+
+template<>
+inline XrSpaceLocationsKHR makeStruct<XrSpaceLocationsKHR>() {
+    return { XR_TYPE_SPACE_LOCATIONS_KHR };
+}
+
+template<>
+inline XrSpaceVelocitiesKHR makeStruct<XrSpaceVelocitiesKHR>() {
+    return { XR_TYPE_SPACE_VELOCITIES_KHR };
+}
+#endif
+
 template<>
 inline XrActionSetCreateInfo makeStruct<XrActionSetCreateInfo>() {
     return { XR_TYPE_ACTION_SET_CREATE_INFO };
@@ -264,6 +311,11 @@ inline VkImageCreateInfo makeStruct<VkImageCreateInfo>() {
     return { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
 }
 
+template<>
+inline VkCommandPoolCreateInfo makeStruct<VkCommandPoolCreateInfo>() {
+    return { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+}
+
 template<>
 inline VkCommandBufferAllocateInfo makeStruct<VkCommandBufferAllocateInfo>() {
     return { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
@@ -314,6 +366,11 @@ inline VkPhysicalDeviceDynamicRenderingFeatures makeStruct<VkPhysicalDeviceDynam
     return { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES };
 }
 
+template<>
+inline VkPhysicalDeviceTimelineSemaphoreFeatures makeStruct<VkPhysicalDeviceTimelineSemaphoreFeatures>() {
+    return { VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES };
+}
+
 template<>
 inline VkDeviceCreateInfo makeStruct<VkDeviceCreateInfo>() {
     return { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
@@ -355,6 +412,11 @@ inline VkShaderModuleCreateInfo makeStruct<VkShaderModuleCreateInfo>() {
     return { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
 }
 
+template<>
+inline VkPipelineCacheCreateInfo makeStruct<VkPipelineCacheCreateInfo>() {
+    return { VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+}
+
 
 template<>
 inline VkPipelineShaderStageCreateInfo makeStruct<VkPipelineShaderStageCreateInfo>() {
@@ -436,6 +498,21 @@ inline VkSemaphoreCreateInfo makeStruct<VkSemaphoreCreateInfo>() {
     return { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
 }
 
+template<>
+inline VkSemaphoreTypeCreateInfo makeStruct<VkSemaphoreTypeCreateInfo>() {
+    return { VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+}
+
+template<>
+inline VkTimelineSemaphoreSubmitInfo makeStruct<VkTimelineSemaphoreSubmitInfo>() {
+    return { VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO };
+}
+
+template<>
+inline VkSemaphoreWaitInfo makeStruct<VkSemaphoreWaitInfo>() {
+    return { VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+}
+
 template<>
 inline VkFenceCreateInfo makeStruct<VkFenceCreateInfo>() {
     return { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO };
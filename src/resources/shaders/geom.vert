@@ -6,13 +6,23 @@ layout(location = 2) in vec3 tangent;
 layout(location = 3) in vec3 bitangent;
 layout(location = 4) in vec2 uv;
 layout(location = 5) in vec4 color;
+layout(location = 6) in mat4 model;    // per instance, locations 6 to 9
+layout(location = 10) in vec3 scale;   // per instance, applied to the latched pose
+layout(location = 11) in uint space;   // per instance, index into the latched spaces, ~0 when not attached to one
 
-layout(push_constant) uniform Globals {
-    mat4 model;
+layout(set = 0, binding = 2) uniform Camera {
     mat4 view;
     mat4 projection;
 };
 
+// poses located again right before submission, see vr::LatchedPoses
+layout(set = 0, binding = 3) readonly buffer LatchedPoses {
+    mat4 views[4];
+    mat4 spaces[32];
+    uint viewCount;
+    uint spaceCount;
+} latched;
+
 layout(set = 0, binding = 0) buffer Debug {
     vec4 positions[];
 } debug;
@@ -26,5 +36,10 @@ void main() {
     vs_out.normal = normal;
     debug.positions[gl_VertexIndex] = position;
 
-    gl_Position = projection * view * model * position;
+    mat4 world = model;
+    if(space < latched.spaceCount) {
+        world = latched.spaces[space] * mat4(vec4(scale.x, 0, 0, 0), vec4(0, scale.y, 0, 0), vec4(0, 0, scale.z, 0), vec4(0, 0, 0, 1));
+    }
+
+    gl_Position = projection * view * world * position;
 }
@@ -0,0 +1,33 @@
+#version 460
+
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec3 normal;
+
+layout(set = 0, binding = 2) uniform Camera {
+    mat4 view;
+    mat4 projection;
+};
+
+// joints of both hands, left hand first, laid out as vr::HandJoints. one instance per joint
+layout(set = 0, binding = 1) readonly buffer Joints {
+    vec4 positions[52];     // xyz position, w radius, 0 for joints that were not located
+    vec4 orientations[52];  // quaternion as x, y, z, w
+} joints;
+
+layout(location = 0) out struct {
+    vec3 normal;
+} vs_out;
+
+vec3 rotate(vec4 q, vec3 v) {
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+void main() {
+    vec4 joint = joints.positions[gl_InstanceIndex];
+    vec4 orientation = joints.orientations[gl_InstanceIndex];
+
+    vs_out.normal = rotate(orientation, normal);
+
+    vec3 worldPosition = joint.xyz + rotate(orientation, position.xyz * joint.w * 2.0);
+    gl_Position = projection * view * vec4(worldPosition, 1);
+}